@@ -0,0 +1,289 @@
+#include <cstring>
+#include <string>
+#include "board.h"
+#include "board_batch.h"
+#include "corpus.h"
+#include "evaluator.h"
+#include "game.h"
+#include "harness.h"
+#include "movegen.h"
+#include "selfplay.h"
+#include "tetromino.h"
+#include "transposition_table.h"
+
+// Usage: tetris_bench [--csv] [name-filter]
+
+static constexpr TetrominoType ALL_TYPES[] = {
+    TetrominoType::I, TetrominoType::J, TetrominoType::L, TetrominoType::O,
+    TetrominoType::S, TetrominoType::T, TetrominoType::Z,
+};
+
+// Board with `lines` rows at the bottom that only lack column 0, so a
+// vertical I dropped into column 0 clears exactly that many lines
+static Board lineClearBoard(int lines) {
+    Board board;
+    for (int i = 0; i < lines; ++i)
+        board.setRow(BOARD_ROWS_TOTAL - 1 - i, FULL_ROW_MASK & ~1u);
+    return board;
+}
+
+static void benchBoard(bench::Runner& runner) {
+    for (const auto& entry : corpus()) {
+        const Board& board = entry.board;
+
+        runner.run("Board::isValidPosition/" + entry.name, [&](int64_t iters) {
+            int64_t ops = 0;
+            for (int64_t it = 0; it < iters; ++it) {
+                const TetrominoType type = ALL_TYPES[it % 7];
+                Tetromino piece(type);
+                int valid = 0;
+                for (int rot = 0; rot < 4; ++rot)
+                    for (int y = 0; y < BOARD_ROWS_TOTAL; ++y)
+                        for (int x = -1; x <= BOARD_COLS; ++x)
+                            valid += board.isValidPosition(piece, {x, y}, rot);
+                bench::doNotOptimize(valid);
+                ops += 4 * BOARD_ROWS_TOTAL * (BOARD_COLS + 2);
+            }
+            return ops;
+        });
+
+        // One op is a whole rotation attempt: up to five kick candidates
+        runner.run("Board::firstFreeKick<T>/" + entry.name, [&](int64_t iters) {
+            int64_t ops = 0;
+            for (int64_t it = 0; it < iters; ++it) {
+                int found = 0;
+                for (int rot = 0; rot < 4; ++rot)
+                    for (int y = 0; y < BOARD_ROWS_TOTAL; ++y)
+                        for (int x = 0; x < BOARD_COLS; ++x)
+                            found += board.firstFreeKick<TetrominoType::T>({x, y}, rot, it & 1 ? 1 : -1);
+                bench::doNotOptimize(found);
+                ops += 4 * BOARD_ROWS_TOTAL * BOARD_COLS;
+            }
+            return ops;
+        });
+
+        runner.run("Board::ghostDropDistance/" + entry.name, [&](int64_t iters) {
+            int64_t ops = 0;
+            for (int64_t it = 0; it < iters; ++it) {
+                Tetromino piece(ALL_TYPES[it % 7]);
+                int total = 0;
+                for (int rot = 0; rot < 4; ++rot) {
+                    piece.setRotation(rot);
+                    for (int x = 0; x < BOARD_COLS; ++x) {
+                        piece.setPosition({x, SPAWN_POSITION.y});
+                        total += board.ghostDropDistance(piece);
+                    }
+                }
+                bench::doNotOptimize(total);
+                ops += 4 * BOARD_COLS;
+            }
+            return ops;
+        });
+
+        runner.run("computeFeatures/" + entry.name, [&](int64_t iters) {
+            for (int64_t it = 0; it < iters; ++it)
+                bench::doNotOptimize(computeFeatures(board));
+            return iters;
+        });
+
+        runner.run("MoveGenerator::generate/" + entry.name, [&](int64_t iters) {
+            static MoveGenerator gen;
+            for (int64_t it = 0; it < iters; ++it)
+                bench::doNotOptimize(gen.generate(board, ALL_TYPES[it % 7]));
+            return iters;
+        });
+    }
+
+    for (int lines = 0; lines <= 4; ++lines) {
+        const Board prepared = lineClearBoard(lines);
+        Tetromino   vertical(TetrominoType::I);
+        vertical.setRotation(3); // cells at pivot column, rows -1..2
+        vertical.setPosition({0, BOARD_ROWS_TOTAL - 3});
+
+        runner.run("Board::lockPiece/" + std::to_string(lines) + "-lines", [&](int64_t iters) {
+            for (int64_t it = 0; it < iters; ++it) {
+                Board board = prepared;
+                bench::doNotOptimize(board.lockPiece(vertical));
+            }
+            return iters;
+        });
+    }
+
+    runner.run("Board copy (lockPiece baseline)", [&](int64_t iters) {
+        const Board prepared = lineClearBoard(4);
+        for (int64_t it = 0; it < iters; ++it) {
+            Board board = prepared;
+            bench::doNotOptimize(board);
+        }
+        return iters;
+    });
+}
+
+// Ops are lanes, so numbers compare directly with the single-Board benchmarks
+static void benchBatch(bench::Runner& runner) {
+    constexpr int LANES = 64;
+    const auto&   boards = corpus();
+    BoardBatch    prepared(LANES);
+    for (int l = 0; l < LANES; ++l)
+        prepared.setLane(l, boards[l % boards.size()].board);
+
+    const std::string kernel = BoardBatch::kernelName();
+
+    runner.run("BoardBatch::validPositions per lane (" + kernel + ")", [&](int64_t iters) {
+        uint8_t out[LANES];
+        int64_t ops = 0;
+        for (int64_t it = 0; it < iters; ++it) {
+            prepared.validPositions(ALL_TYPES[it % 7], {static_cast<int>(it % 8) + 1, 12},
+                                    static_cast<int>(it & 3), out);
+            bench::doNotOptimize(out);
+            ops += LANES;
+        }
+        return ops;
+    });
+
+    runner.run("BoardBatch::lockPiece per lane (" + kernel + ")", [&](int64_t iters) {
+        uint8_t out[LANES];
+        int64_t ops = 0;
+        for (int64_t it = 0; it < iters; ++it) {
+            BoardBatch batch = prepared;
+            batch.lockPiece(TetrominoType::I, {0, BOARD_ROWS_TOTAL - 3}, 3, out);
+            bench::doNotOptimize(out);
+            ops += LANES;
+        }
+        return ops;
+    });
+}
+
+static void benchTetromino(bench::Runner& runner) {
+    runner.run("Tetromino::worldCellsAt", [&](int64_t iters) {
+        int64_t ops = 0;
+        for (int64_t it = 0; it < iters; ++it) {
+            Tetromino piece(ALL_TYPES[it % 7]);
+            for (int rot = 0; rot < 4; ++rot) {
+                auto cells = piece.worldCellsAt({static_cast<int>(it & 7), 10}, rot);
+                bench::doNotOptimize(cells);
+            }
+            ops += 4;
+        }
+        return ops;
+    });
+}
+
+static void benchGame(bench::Runner& runner) {
+    // Rotations against the left wall: most attempts need at least one kick.
+    // Each op is one Game::step carrying a rotation (includes one gravity tick).
+    runner.run("Game::step rotate at wall (kicks)", [&](int64_t iters) {
+        int64_t ops = 0;
+        uint32_t seed = 1;
+        while (ops < iters) {
+            Game game(seed++);
+            for (int i = 0; i < BOARD_COLS; ++i)
+                game.step(actionBit(Action::MoveLeft));
+            for (int i = 0; i < 200 && ops < iters; ++i, ++ops)
+                game.step(actionBit((i & 1) ? Action::RotateCCW : Action::RotateCW));
+        }
+        return ops;
+    });
+
+    // Ops are pieces: measures raw Game overhead with a trivial policy
+    runner.run("Game full game (hard drop only) per piece", [&](int64_t iters) {
+        int64_t pieces = 0;
+        uint32_t seed = 1;
+        while (pieces < iters) {
+            Policy drop = [](const Game&) { return actionBit(Action::HardDrop); };
+            pieces += SelfPlayRunner::playOne(seed++, drop).pieces;
+        }
+        return pieces;
+    });
+
+    runner.run("Game full game (RandomPolicy) per piece", [&](int64_t iters) {
+        int64_t pieces = 0;
+        uint32_t seed = 1;
+        while (pieces < iters) {
+            pieces += SelfPlayRunner::playOne(seed, RandomPolicy(seed)).pieces;
+            ++seed;
+        }
+        return pieces;
+    });
+
+    // Clone-and-search primitives on a mid-game position
+    Game midGame(7);
+    {
+        Policy policy = RandomPolicy(7);
+        while (midGame.pieces() < 20 && midGame.state() == GameState::Playing)
+            midGame.step(policy(midGame));
+    }
+
+    runner.run("Game copy", [&](int64_t iters) {
+        for (int64_t it = 0; it < iters; ++it) {
+            Game clone = midGame;
+            bench::doNotOptimize(clone);
+        }
+        return iters;
+    });
+
+    runner.run("Game snapshot+restore", [&](int64_t iters) {
+        Game clone(7);
+        for (int64_t it = 0; it < iters; ++it) {
+            const GameSnapshot snap = midGame.snapshot();
+            clone.restore(snap);
+            bench::doNotOptimize(clone);
+        }
+        return iters;
+    });
+
+    // Ops are pieces: a deep preview mostly computed from bags past the buffer
+    runner.run("Game::peekPieces(64) per piece", [&](int64_t iters) {
+        TetrominoType preview[64];
+        int64_t       ops = 0;
+        while (ops < iters) {
+            midGame.peekPieces(preview, 64);
+            bench::doNotOptimize(preview);
+            ops += 64;
+        }
+        return ops;
+    });
+
+    // Capped: the bot survives far longer than a benchmark iteration should
+    runner.run("Game (BeamSearchPolicy) per piece", [&](int64_t iters) {
+        int64_t pieces = 0;
+        uint32_t seed = 1;
+        while (pieces < iters)
+            pieces += SelfPlayRunner::playOne(seed++, BeamSearchPolicy(), 50).pieces;
+        return pieces;
+    });
+}
+
+// Ops are one probe plus one store of a corpus position's hash
+static void benchSearch(bench::Runner& runner) {
+    runner.run("TranspositionTable probe+store", [&](int64_t iters) {
+        static TranspositionTable table(1 << 20);
+        const auto& boards = corpus();
+        uint64_t    found  = 0;
+        for (int64_t it = 0; it < iters; ++it) {
+            const uint64_t key = boards[it % boards.size()].board.hash() + static_cast<uint64_t>(it);
+            uint64_t value;
+            if (table.probe(key, value)) found += value;
+            table.store(key, static_cast<uint64_t>(it));
+        }
+        bench::doNotOptimize(found);
+        return iters;
+    });
+}
+
+int main(int argc, char** argv) {
+    bool        csv = false;
+    std::string filter;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--csv") == 0) csv = true;
+        else                                    filter = argv[i];
+    }
+
+    bench::Runner runner(filter, csv);
+    benchBoard(runner);
+    benchBatch(runner);
+    benchTetromino(runner);
+    benchGame(runner);
+    benchSearch(runner);
+    return 0;
+}
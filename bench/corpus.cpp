@@ -0,0 +1,77 @@
+#include "corpus.h"
+
+Board boardFromRows(const std::vector<std::string>& rows) {
+    Board board;
+    int row = BOARD_ROWS_TOTAL - static_cast<int>(rows.size());
+    for (const auto& text : rows) {
+        uint16_t mask = 0;
+        for (int c = 0; c < BOARD_COLS && c < static_cast<int>(text.size()); ++c)
+            if (text[c] == '#') mask |= static_cast<uint16_t>(1u << c);
+        board.setRow(row++, mask);
+    }
+    return board;
+}
+
+const std::vector<CorpusBoard>& corpus() {
+    static const std::vector<CorpusBoard> boards = {
+        { "empty", Board{} },
+
+        // Clean stack with a right-side well, typical of a tetris-building bot
+        { "flat-well", boardFromRows({
+            "#########.",
+            "#########.",
+            "#########.",
+            "#########.",
+            "#########.",
+            "#########.",
+        }) },
+
+        // T-spin double setup: overhang that needs a kick to fill
+        { "tspin-slot", boardFromRows({
+            "##........",
+            "#.........",
+            "#.......##",
+            "###.######",
+            "##..######",
+            "###.######",
+            "#########.",
+            "########..",
+        }) },
+
+        // Ragged mid-game stack with holes and covered cells
+        { "messy-mid", boardFromRows({
+            "....#.....",
+            "...###...#",
+            "#.####..##",
+            "##.###.###",
+            "####.#####",
+            "#.###.####",
+            "###.######",
+            "#####.####",
+            "##.####.##",
+            "#########.",
+        }) },
+
+        // Near top-out: tall columns with a narrow gap in the middle
+        { "tall-danger", boardFromRows({
+            "###....###",
+            "###....###",
+            "####..####",
+            "####..####",
+            "####..####",
+            "#####.####",
+            "#####.####",
+            "#.###.###.",
+            "#.###.####",
+            "##.#######",
+            "####.#####",
+            "#######.##",
+            "###.######",
+            "######.###",
+            "#.########",
+            "########.#",
+            "##.#######",
+        }) },
+    };
+    return boards;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "board.h"
+
+// Fixed board positions shared by every benchmark so numbers are comparable
+// between runs and commits.
+struct CorpusBoard {
+    std::string name;
+    Board       board;
+};
+
+// Builds a board from text rows, bottom row last: '#' filled, '.' empty
+Board boardFromRows(const std::vector<std::string>& rows);
+
+const std::vector<CorpusBoard>& corpus();
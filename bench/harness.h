@@ -0,0 +1,87 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Minimal repeatable microbenchmark harness. Each benchmark is calibrated to
+// a batch of ~TARGET_BATCH_NS, warmed up once, then timed over SAMPLES
+// batches; the median per-op time is reported together with the fastest
+// batch so noisy runs are easy to spot.
+namespace bench {
+
+// Keeps the optimizer from discarding a computed value
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct Result {
+    std::string name;
+    double      medianNs = 0.0; // per op
+    double      minNs    = 0.0; // per op, fastest batch
+    int64_t     opsPerBatch = 0;
+};
+
+class Runner {
+public:
+    static constexpr int     SAMPLES        = 15;
+    static constexpr int64_t TARGET_BATCH_NS = 20'000'000;
+
+    Runner(std::string filter, bool csv) : m_filter(std::move(filter)), m_csv(csv) {
+        if (m_csv) std::printf("name,median_ns,min_ns,ops_per_batch\n");
+        else       std::printf("%-52s %14s %14s\n", "benchmark", "median ns/op", "min ns/op");
+    }
+
+    // fn(iterations) runs the measured operation `iterations` times and
+    // returns how many ops it performed (usually == iterations)
+    template <typename Fn>
+    void run(const std::string& name, Fn&& fn) {
+        if (!m_filter.empty() && name.find(m_filter) == std::string::npos) return;
+
+        using Clock = std::chrono::steady_clock;
+        auto timeBatch = [&](int64_t iters, int64_t& ops) {
+            auto t0 = Clock::now();
+            ops = fn(iters);
+            return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        };
+
+        // Calibrate: grow the batch until it takes long enough to time reliably
+        int64_t iters = 1, ops = 0;
+        for (;;) {
+            double ns = timeBatch(iters, ops);
+            if (ns >= TARGET_BATCH_NS / 4 || iters >= (int64_t(1) << 40)) {
+                iters = std::max<int64_t>(1, static_cast<int64_t>(iters * (TARGET_BATCH_NS / std::max(ns, 1.0))));
+                break;
+            }
+            iters *= 4;
+        }
+
+        timeBatch(iters, ops); // warm-up
+        std::vector<double> perOp;
+        for (int s = 0; s < SAMPLES; ++s) {
+            double ns = timeBatch(iters, ops);
+            perOp.push_back(ns / std::max<int64_t>(ops, 1));
+        }
+        std::sort(perOp.begin(), perOp.end());
+
+        Result r{name, perOp[SAMPLES / 2], perOp.front(), ops};
+        if (m_csv) std::printf("%s,%.3f,%.3f,%lld\n", r.name.c_str(), r.medianNs, r.minNs,
+                               static_cast<long long>(r.opsPerBatch));
+        else       std::printf("%-52s %14.2f %14.2f\n", r.name.c_str(), r.medianNs, r.minNs);
+        std::fflush(stdout);
+    }
+
+private:
+    std::string m_filter;
+    bool        m_csv;
+};
+
+} // namespace bench
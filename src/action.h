@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+
+enum class Action {
+    MoveLeft,
+    MoveRight,
+    SoftDrop,
+    HardDrop,
+    RotateCW,
+    RotateCCW,
+    Hold,
+    Pause,
+    Quit,
+    Count
+};
+
+constexpr int ACTION_COUNT = static_cast<int>(Action::Count);
+
+// Actions firing this frame, one bit per Action — the only input Game sees
+constexpr uint16_t actionBit(Action a) { return static_cast<uint16_t>(1u << static_cast<int>(a)); }
+
+constexpr bool hasAction(uint16_t mask, Action a) { return (mask & actionBit(a)) != 0; }
+
+// Bits 12-15 hold how many times MoveLeft/MoveRight repeat within one tick,
+// minus one, so DAS can fire several shifts (or slide to the wall) per tick
+constexpr int MOVE_REPEAT_SHIFT = 12;
+constexpr int MAX_MOVE_REPEATS  = 16;
+
+constexpr int moveRepeats(uint16_t mask) { return ((mask >> MOVE_REPEAT_SHIFT) & 0xF) + 1; }
+
+constexpr uint16_t withMoveRepeats(uint16_t mask, int repeats) {
+    repeats = repeats < 1 ? 1 : (repeats > MAX_MOVE_REPEATS ? MAX_MOVE_REPEATS : repeats);
+    return static_cast<uint16_t>((mask & ~(0xFu << MOVE_REPEAT_SHIFT)) |
+                                 ((repeats - 1) << MOVE_REPEAT_SHIFT));
+}
@@ -0,0 +1,21 @@
+#include "bag.h"
+#include <utility>
+#include "zobrist.h"
+
+// Fisher-Yates driven by SplitMix64 over (seed, bag number). Written out
+// rather than std::shuffle, whose algorithm differs between standard
+// libraries, so a seed deals the same pieces on every platform.
+Bag bagAt(uint32_t seed, uint32_t bag) {
+    Bag out;
+    for (int i = 0; i < 7; ++i) out[i] = static_cast<TetrominoType>(i);
+    uint64_t state = (static_cast<uint64_t>(seed) << 32) | bag;
+    for (int i = 6; i > 0; --i) {
+        const int j = static_cast<int>(((splitMix64(state) >> 32) * (i + 1)) >> 32);
+        std::swap(out[i], out[j]);
+    }
+    return out;
+}
+
+TetrominoType pieceAt(uint32_t seed, uint64_t index) {
+    return bagAt(seed, static_cast<uint32_t>(index / 7))[index % 7];
+}
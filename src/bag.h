@@ -0,0 +1,15 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "tetromino.h"
+
+// The 7-bag piece sequence as a pure function of the game seed: bag n is
+// shuffled from (seed, n) alone, so any bag or piece can be computed
+// directly without dealing the ones before it. Game buffers two bags of
+// this sequence; search and replay tools can index it at any distance.
+using Bag = std::array<TetrominoType, 7>;
+
+Bag bagAt(uint32_t seed, uint32_t bag);
+
+// Piece number `index` of the sequence (0 = the first piece of the game)
+TetrominoType pieceAt(uint32_t seed, uint64_t index);
@@ -1,12 +1,64 @@
 #include "board.h"
 #include <algorithm>
+#include "zobrist.h"
+
+// Tabulation keys per row, indexed by each 5-column half of the row mask so a
+// whole row hashes with two lookups. Index 0 (empty half) is 0: empty rows
+// contribute nothing, and rows that move during a clear are rehashed cheaply.
+namespace {
+constexpr int ROW_HALF_BITS = 5;
+static_assert(BOARD_COLS <= 2 * ROW_HALF_BITS, "row key tables cover 10 columns");
+
+struct RowKeys {
+    uint64_t lo[BOARD_ROWS_TOTAL][1 << ROW_HALF_BITS];
+    uint64_t hi[BOARD_ROWS_TOTAL][1 << ROW_HALF_BITS];
+    uint64_t empty; // hash of the empty board, nonzero so it can't alias an unused key
+};
+
+RowKeys buildRowKeys() {
+    RowKeys keys{};
+    uint64_t state = 0x7E7215B0A4D1C3ull;
+    for (int r = 0; r < BOARD_ROWS_TOTAL; ++r) {
+        for (int m = 1; m < (1 << ROW_HALF_BITS); ++m) {
+            keys.lo[r][m] = splitMix64(state);
+            keys.hi[r][m] = splitMix64(state);
+        }
+    }
+    keys.empty = splitMix64(state);
+    return keys;
+}
+
+const RowKeys ROW_KEYS = buildRowKeys();
+
+constexpr uint32_t HALF_MASK = (1u << ROW_HALF_BITS) - 1;
+
+uint64_t rowKey(int row, uint16_t mask) {
+    return ROW_KEYS.lo[row][mask & HALF_MASK] ^ ROW_KEYS.hi[row][mask >> ROW_HALF_BITS];
+}
+
+// Index of the lowest set bit; x must be nonzero
+inline int lowestBit(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#else
+    int i = 0;
+    while (!((x >> i) & 1u)) ++i;
+    return i;
+#endif
+}
+} // namespace
 
 Board::Board() {
     reset();
 }
 
 void Board::reset() {
-    for (auto& row : m_cells)
+    ++m_version;
+    m_lastCleared = 0;
+    m_hash        = ROW_KEYS.empty;
+    m_rows.fill(0);
+    m_colTops.fill(BOARD_ROWS_TOTAL);
+    for (auto& row : m_colors)
         row.fill(EMPTY_COLOR);
 }
 
@@ -16,44 +68,167 @@ bool Board::isInBounds(int col, int row) const {
 
 bool Board::isOccupied(int col, int row) const {
     if (!isInBounds(col, row)) return true; // treat out-of-bounds as occupied
-    return m_cells[row][col] != EMPTY_COLOR;
+    return (m_rows[row] >> col) & 1u;
+}
+
+Color Board::cellColor(int col, int row) const {
+    if (!isInBounds(col, row) || !((m_rows[row] >> col) & 1u)) return EMPTY_COLOR;
+    return m_colors[row][col];
 }
 
-sf::Color Board::cellColor(int col, int row) const {
-    if (!isInBounds(col, row)) return EMPTY_COLOR;
-    return m_cells[row][col];
+void Board::setRow(int row, uint16_t mask, Color color) {
+    if (row < 0 || row >= BOARD_ROWS_TOTAL) return;
+    ++m_version;
+    m_hash     ^= rowKey(row, m_rows[row]) ^ rowKey(row, mask & FULL_ROW_MASK);
+    m_rows[row] = mask & FULL_ROW_MASK;
+    for (int c = 0; c < BOARD_COLS; ++c)
+        m_colors[row][c] = ((mask >> c) & 1u) ? color : EMPTY_COLOR;
+    rebuildColumnTops();
+}
+
+void Board::setRow(int row, uint16_t mask, const std::array<Color, BOARD_COLS>& colors) {
+    if (row < 0 || row >= BOARD_ROWS_TOTAL) return;
+    ++m_version;
+    m_hash     ^= rowKey(row, m_rows[row]) ^ rowKey(row, mask & FULL_ROW_MASK);
+    m_rows[row] = mask & FULL_ROW_MASK;
+    for (int c = 0; c < BOARD_COLS; ++c)
+        m_colors[row][c] = ((mask >> c) & 1u) ? colors[c] : EMPTY_COLOR;
+    rebuildColumnTops();
+}
+
+static constexpr int SNAPSHOT_ROWS_PER_WORD = 6;
+
+BoardSnapshot Board::snapshot() const {
+    BoardSnapshot snap{};
+    for (int r = 0; r < BOARD_ROWS_TOTAL; ++r) {
+        const int word = r / SNAPSHOT_ROWS_PER_WORD, slot = r % SNAPSHOT_ROWS_PER_WORD;
+        snap.cells[word] |= static_cast<uint64_t>(m_rows[r]) << (BOARD_COLS * slot);
+    }
+    return snap;
+}
+
+void Board::restore(const BoardSnapshot& snap) {
+    ++m_version;
+    m_lastCleared = 0;
+    m_hash        = ROW_KEYS.empty;
+    for (int r = 0; r < BOARD_ROWS_TOTAL; ++r) {
+        const int      word = r / SNAPSHOT_ROWS_PER_WORD, slot = r % SNAPSHOT_ROWS_PER_WORD;
+        const uint16_t mask = static_cast<uint16_t>((snap.cells[word] >> (BOARD_COLS * slot)) & FULL_ROW_MASK);
+        m_rows[r] = mask;
+        m_hash   ^= rowKey(r, mask);
+        // Colors only matter under set bits, so a whole-row fill will do
+        if (mask) m_colors[r].fill(GARBAGE_COLOR);
+    }
+    rebuildColumnTops();
+}
+
+bool Board::addGarbage(int lines, int holeColumn) {
+    lines      = std::min(lines, BOARD_ROWS_TOTAL);
+    holeColumn = std::clamp(holeColumn, 0, BOARD_COLS - 1);
+    if (lines <= 0) return true;
+    ++m_version;
+
+    bool overflow = false;
+    for (int r = 0; r < lines; ++r)
+        overflow |= m_rows[r] != 0;
+
+    // Every row moves, so the hash is rebuilt rather than patched
+    for (int r = 0; r + lines < BOARD_ROWS_TOTAL; ++r) {
+        m_rows[r]   = m_rows[r + lines];
+        m_colors[r] = m_colors[r + lines];
+    }
+    const uint16_t garbage = FULL_ROW_MASK & ~static_cast<uint16_t>(1u << holeColumn);
+    for (int r = BOARD_ROWS_TOTAL - lines; r < BOARD_ROWS_TOTAL; ++r) {
+        m_rows[r] = garbage;
+        m_colors[r].fill(GARBAGE_COLOR);
+    }
+
+    m_hash = ROW_KEYS.empty;
+    for (int r = 0; r < BOARD_ROWS_TOTAL; ++r)
+        m_hash ^= rowKey(r, m_rows[r]);
+    rebuildColumnTops();
+    return !overflow;
 }
 
 bool Board::isValidPosition(const Tetromino& piece,
-                             sf::Vector2i    testPos,
+                             Vec2i           testPos,
                              int             testRotation) const {
-    const auto cells = piece.worldCellsAt(testPos, testRotation);
-    for (const auto& c : cells) {
-        if (!isInBounds(c.x, c.y)) return false;
-        if (m_cells[c.y][c.x] != EMPTY_COLOR) return false;
-    }
-    return true;
+    return withPieceType(piece.type(), [&](auto type) {
+        return fits<decltype(type)::value>(testPos, testRotation);
+    });
 }
 
 int Board::lockPiece(const Tetromino& piece) {
-    for (const auto& c : piece.worldCells())
-        if (isInBounds(c.x, c.y))
-            m_cells[c.y][c.x] = piece.color();
+    ++m_version;
+    int first = BOARD_ROWS_TOTAL, last = -1;
+    for (const auto& c : piece.worldCells()) {
+        if (!isInBounds(c.x, c.y)) continue;
+        const uint16_t before = m_rows[c.y];
+        m_rows[c.y] |= static_cast<uint16_t>(1u << c.x);
+        m_hash ^= rowKey(c.y, before) ^ rowKey(c.y, m_rows[c.y]);
+        m_colors[c.y][c.x] = piece.color();
+        if (c.y < m_colTops[c.x]) m_colTops[c.x] = static_cast<int8_t>(c.y);
+        first = std::min(first, c.y);
+        last  = std::max(last, c.y);
+    }
+
+    // Only rows the piece touched can have become full
+    m_lastCleared = 0;
+    for (int r = first; r <= last; ++r)
+        if (m_rows[r] == FULL_ROW_MASK) m_lastCleared |= 1u << r;
+    if (!m_lastCleared) return 0;
 
-    auto fullRows = findFullRows();
+    // Every row from the lowest cleared one up to the stack top changes
+    // index: unhash them here and rehash after compaction (empty rows hash 0)
+    const int stackTop = *std::min_element(m_colTops.begin(), m_colTops.end());
+    for (int r = stackTop; r <= last; ++r)
+        m_hash ^= rowKey(r, m_rows[r]);
 
-    // Clear from bottom to top to avoid index drift
-    std::sort(fullRows.begin(), fullRows.end(), std::greater<int>());
-    for (int row : fullRows)
-        clearRow(row);
+    // Single bottom-up pass from the lowest cleared row: every kept row moves
+    // straight to its final slot, then the vacated top rows are emptied
+    int dst = last;
+    for (int src = last; src >= 0; --src) {
+        if ((m_lastCleared >> src) & 1u) continue;
+        if (dst != src) {
+            m_rows[dst]   = m_rows[src];
+            m_colors[dst] = m_colors[src];
+        }
+        --dst;
+    }
+    for (; dst >= 0; --dst) {
+        m_rows[dst] = 0;
+        m_colors[dst].fill(EMPTY_COLOR);
+    }
+    for (int r = stackTop; r <= last; ++r)
+        m_hash ^= rowKey(r, m_rows[r]);
+    rebuildColumnTops();
 
-    return static_cast<int>(fullRows.size());
+    int cleared = 0;
+    for (uint32_t bits = m_lastCleared; bits; bits &= bits - 1)
+        ++cleared;
+    return cleared;
 }
 
 int Board::ghostDropDistance(const Tetromino& piece) const {
+    // Each column of the piece can fall until its lowest cell rests on that
+    // column's surface. That only holds while the piece is above the surface
+    // everywhere; under an overhang, fall back to probing row by row.
+    const PieceMask& mask = pieceMask(piece.type(), piece.rotationState());
+    const Vec2i      pos  = piece.position();
+    int  fastDist     = BOARD_ROWS_TOTAL;
+    bool aboveSurface = true;
+    for (int i = 0; i <= mask.maxX - mask.minX; ++i) {
+        const int col = pos.x + mask.minX + i;
+        if (col < 0 || col >= BOARD_COLS) { aboveSurface = false; break; }
+        const int gap = m_colTops[col] - 1 - (pos.y + mask.bottoms[i]);
+        if (gap < 0) { aboveSurface = false; break; }
+        fastDist = std::min(fastDist, gap);
+    }
+    if (aboveSurface) return fastDist;
+
     int dist = 0;
     while (dist < BOARD_ROWS_TOTAL) {
-        sf::Vector2i testPos = piece.position() + sf::Vector2i{0, dist + 1};
+        Vec2i testPos = piece.position() + Vec2i{0, dist + 1};
         if (!isValidPosition(piece, testPos, piece.rotationState()))
             break;
         ++dist;
@@ -61,22 +236,13 @@ int Board::ghostDropDistance(const Tetromino& piece) const {
     return dist;
 }
 
-std::vector<int> Board::findFullRows() const {
-    std::vector<int> full;
-    for (int r = 0; r < BOARD_ROWS_TOTAL; ++r) {
-        bool rowFull = true;
-        for (int c = 0; c < BOARD_COLS; ++c) {
-            if (m_cells[r][c] == EMPTY_COLOR) { rowFull = false; break; }
-        }
-        if (rowFull) full.push_back(r);
+void Board::rebuildColumnTops() {
+    m_colTops.fill(BOARD_ROWS_TOTAL);
+    uint16_t seen = 0;
+    for (int r = 0; r < BOARD_ROWS_TOTAL && seen != FULL_ROW_MASK; ++r) {
+        // Each column is visited once, at the first row that fills it
+        for (uint32_t fresh = m_rows[r] & ~seen; fresh; fresh &= fresh - 1)
+            m_colTops[lowestBit(fresh)] = static_cast<int8_t>(r);
+        seen |= m_rows[r];
     }
-    return full;
-}
-
-void Board::clearRow(int row) {
-    // Shift all rows above down by one
-    for (int r = row; r > 0; --r)
-        m_cells[r] = m_cells[r - 1];
-    // Top row becomes empty
-    m_cells[0].fill(EMPTY_COLOR);
 }
@@ -1,14 +1,131 @@
 #pragma once
 #include <array>
-#include <vector>
-#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include "piece_tables.h"
 #include "tetromino.h"
 
 constexpr int BOARD_COLS       = 10;
 constexpr int BOARD_ROWS       = 20; // visible rows
 constexpr int BOARD_ROWS_TOTAL = 22; // +2 hidden spawn rows at top
 
-inline const sf::Color EMPTY_COLOR = sf::Color::Black;
+// Where new pieces appear: top-center, in the hidden rows (col 4 on 10-wide)
+constexpr Vec2i SPAWN_POSITION{BOARD_COLS / 2 - 1, 1};
+
+// Row occupancy bitmask: bit c set = column c filled
+constexpr uint16_t FULL_ROW_MASK = (1u << BOARD_COLS) - 1;
+
+// Piece masks pre-shifted onto board columns, one per pivot column x in
+// [PIECE_COLUMN_MIN, PIECE_COLUMN_MIN + PIECE_COLUMN_SPAN). rows[i] covers
+// board row y + top + i for pivot row y (zero past the state's height).
+// topSpan counts the values of y + top that keep the piece on the board, so
+// a single unsigned compare bounds-checks a position; it is 0 when column x
+// pushes the piece off either side.
+struct ColumnMask {
+    uint16_t rows[4];
+    int8_t   top;
+    uint8_t  topSpan;
+};
+
+constexpr int PIECE_COLUMN_MIN  = -4;
+constexpr int PIECE_COLUMN_SPAN = BOARD_COLS + 8; // any kick from an in-bounds pivot
+
+using ColumnMaskTable = std::array<std::array<std::array<ColumnMask, PIECE_COLUMN_SPAN>, 4>, 7>;
+
+constexpr ColumnMaskTable buildColumnMasks() {
+    ColumnMaskTable table{};
+    for (int t = 0; t < 7; ++t) {
+        for (int r = 0; r < 4; ++r) {
+            const PieceMask& mask = PIECE_MASKS[t][r];
+            for (int c = 0; c < PIECE_COLUMN_SPAN; ++c) {
+                ColumnMask& out  = table[t][r][c];
+                const int   left = c + PIECE_COLUMN_MIN + mask.minX;
+                out.top = static_cast<int8_t>(mask.minY);
+                if (left < 0 || c + PIECE_COLUMN_MIN + mask.maxX >= BOARD_COLS) continue;
+                out.topSpan = static_cast<uint8_t>(BOARD_ROWS_TOTAL - mask.height + 1);
+                for (int i = 0; i < mask.height; ++i)
+                    out.rows[i] = static_cast<uint16_t>(mask.rows[i] << left);
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr ColumnMaskTable COLUMN_MASKS = buildColumnMasks();
+
+// nullptr if x is outside the table, which no valid position can reach
+constexpr const ColumnMask* columnMask(TetrominoType type, int rotation, int x) {
+    const unsigned column = static_cast<unsigned>(x - PIECE_COLUMN_MIN);
+    return column < PIECE_COLUMN_SPAN
+         ? &COLUMN_MASKS[static_cast<int>(type)][rotation & 3][column] : nullptr;
+}
+
+// All five SRS kick candidates of one rotation, laid out for a single pass
+// over the board: window row i covers board row y + top + i for pivot row y,
+// and bits [10k, 10k + 10) of rows[i] hold kick k's piece cells in that row.
+// Indexed by type, source rotation, direction and pivot column like
+// COLUMN_MASKS. Lanes of kicks that push the piece off a side are all set in
+// offBoard, so they read as collisions.
+constexpr int KICK_COUNT       = 5;
+constexpr int KICK_WINDOW_ROWS = 8; // kick y offsets span 5 rows, plus height - 1
+
+struct KickMask {
+    uint64_t rows[KICK_WINDOW_ROWS];
+    uint64_t offBoard;
+    int8_t   top;
+};
+
+// Bit 0 of every kick lane: multiplying a board row by this copies it into
+// each lane
+constexpr uint64_t KICK_LANE_ONES = 1ull | 1ull << 10 | 1ull << 20 | 1ull << 30 | 1ull << 40;
+constexpr uint64_t KICK_LANE_HIGH = KICK_LANE_ONES << (BOARD_COLS - 1);
+static_assert(BOARD_COLS * KICK_COUNT <= 64, "kick lanes must fit one word");
+
+using KickMaskTable =
+    std::array<std::array<std::array<std::array<KickMask, PIECE_COLUMN_SPAN>, 2>, 4>, 7>;
+
+constexpr KickMaskTable buildKickMasks() {
+    KickMaskTable table{};
+    for (int t = 0; t < 7; ++t) {
+        for (int from = 0; from < 4; ++from) {
+            for (int dir = 0; dir < 2; ++dir) {
+                const KickData* kicks = kickDataFor(static_cast<TetrominoType>(t), dir ? 1 : -1);
+                const int       to    = (from + (dir ? 1 : -1)) & 3;
+                const PieceMask& mask = PIECE_MASKS[t][to];
+                int minKickY = 0;
+                for (int k = 0; kicks && k < KICK_COUNT; ++k)
+                    minKickY = kicks->offsets[from][k][1] < minKickY ? kicks->offsets[from][k][1] : minKickY;
+
+                for (int c = 0; c < PIECE_COLUMN_SPAN; ++c) {
+                    KickMask& out = table[t][from][dir][c];
+                    out.top      = static_cast<int8_t>(minKickY + mask.minY);
+                    out.offBoard = FULL_ROW_MASK * KICK_LANE_ONES; // O: nothing to kick
+                    for (int k = 0; kicks && k < KICK_COUNT; ++k) {
+                        const int x    = c + PIECE_COLUMN_MIN + kicks->offsets[from][k][0];
+                        const int left = x + mask.minX;
+                        if (left < 0 || x + mask.maxX >= BOARD_COLS) continue;
+                        out.offBoard &= ~(static_cast<uint64_t>(FULL_ROW_MASK) << (BOARD_COLS * k));
+                        const int row = kicks->offsets[from][k][1] - minKickY;
+                        for (int i = 0; i < mask.height; ++i)
+                            out.rows[row + i] |=
+                                static_cast<uint64_t>(mask.rows[i] << left) << (BOARD_COLS * k);
+                    }
+                }
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr KickMaskTable KICK_MASKS = buildKickMasks();
+
+constexpr Color EMPTY_COLOR{0, 0, 0};
+constexpr Color GARBAGE_COLOR{110, 110, 120}; // cells not placed by a piece
+
+// Occupancy of a Board without colors: six 10-bit rows per word, row r at
+// bit 10 * (r % 6) of cells[r / 6]
+struct BoardSnapshot {
+    uint64_t cells[4];
+};
 
 class Board {
 public:
@@ -18,23 +135,122 @@ public:
 
     bool         isOccupied(int col, int row) const;
     bool         isInBounds(int col, int row) const;
-    sf::Color    cellColor(int col, int row)  const;
+    Color        cellColor(int col, int row)  const;
+    uint16_t     rowMask(int row)             const { return m_rows[row]; }
+
+    // Topmost filled row in col, or BOARD_ROWS_TOTAL if the column is empty
+    int          columnTop(int col)           const { return m_colTops[col]; }
+
+    // Bumped on every change to the locked cells, so observers (the renderer's
+    // cached stack texture) can tell when derived data is stale
+    uint32_t     version()                    const { return m_version; }
+
+    // Zobrist-style hash of the occupancy (colors excluded), kept up to date
+    // incrementally. Equal stacks hash equal however they were built.
+    uint64_t     hash()                       const { return m_hash; }
+
+    // Overwrites a whole row: cells set in mask get color, the rest are emptied
+    void setRow(int row, uint16_t mask, Color color = GARBAGE_COLOR);
+
+    // Same with a color per column (only read where mask is set)
+    void setRow(int row, uint16_t mask, const std::array<Color, BOARD_COLS>& colors);
+
+    // Occupancy in 32 bytes. restore() rebuilds the hash and column profile
+    // and colors every filled cell GARBAGE_COLOR.
+    BoardSnapshot snapshot() const;
+    void          restore(const BoardSnapshot& snap);
+
+    // Pushes the stack up by lines and fills the bottom with garbage rows that
+    // are full except for holeColumn. Returns false if filled cells were
+    // pushed out of the top, which ends the game.
+    bool addGarbage(int lines, int holeColumn);
 
     // Returns true if all 4 cells of the piece are in bounds and unoccupied
     bool isValidPosition(const Tetromino& piece,
-                         sf::Vector2i    testPos,
+                         Vec2i           testPos,
                          int             testRotation) const;
 
+    // isValidPosition for a piece type known at compile time: one table
+    // lookup, one bounds compare and PIECE_HEIGHT<T> row tests
+    template <TetrominoType T>
+    bool fits(Vec2i pos, int rotation) const;
+
+    // SRS rotation test: the index of the first of the five kicks for
+    // rotating from pos/fromRotation in direction (+1 CW, -1 CCW) that
+    // fits<T>, or -1 if none does. All candidates are tested together with
+    // one AND per window row. T must not be O.
+    template <TetrominoType T>
+    int firstFreeKick(Vec2i pos, int fromRotation, int direction) const;
+
     // Locks piece into board; returns number of lines cleared
     int lockPiece(const Tetromino& piece);
 
-    // How many rows the piece can drop before hitting something
+    // Rows cleared by the last lockPiece: bit r set = row r (indexed as it
+    // was before the clear) was full and removed
+    uint32_t lastClearedRows() const { return m_lastCleared; }
+
+    // How many rows the piece can drop before hitting something. O(width)
+    // from the column profile unless the piece is tucked under an overhang.
     int ghostDropDistance(const Tetromino& piece) const;
 
 private:
-    // [row][col], row 0 = topmost hidden row
-    std::array<std::array<sf::Color, BOARD_COLS>, BOARD_ROWS_TOTAL> m_cells;
+    // Occupancy, row 0 = topmost hidden row. fits<T>() reads PIECE_HEIGHT<T>
+    // rows from any in-bounds top, so a few always-empty rows follow the board.
+    static constexpr int ROW_PADDING = 3;
+    std::array<uint16_t, BOARD_ROWS_TOTAL + ROW_PADDING> m_rows;
+
+    // [row][col] colors, only meaningful where m_rows has the bit set;
+    // read by the renderer, never by collision or line-clear code
+    std::array<std::array<Color, BOARD_COLS>, BOARD_ROWS_TOTAL> m_colors;
+
+    // Surface profile: topmost filled row per column (BOARD_ROWS_TOTAL if
+    // empty). Raised cell by cell on lock, rebuilt after rows move.
+    std::array<int8_t, BOARD_COLS> m_colTops;
 
-    std::vector<int> findFullRows() const;
-    void             clearRow(int row);
+    uint32_t m_version     = 0;
+    uint32_t m_lastCleared = 0;
+    uint64_t m_hash        = 0;
+
+    void rebuildColumnTops();
 };
+
+template <TetrominoType T>
+bool Board::fits(Vec2i pos, int rotation) const {
+    const ColumnMask* mask = columnMask(T, rotation, pos.x);
+    if (!mask) return false;
+    const unsigned top = static_cast<unsigned>(pos.y + mask->top);
+    if (top >= mask->topSpan) return false;
+
+    uint16_t hit = 0;
+    for (int i = 0; i < PIECE_HEIGHT<T>; ++i)
+        hit |= m_rows[top + i] & mask->rows[i];
+    return hit == 0;
+}
+
+template <TetrominoType T>
+int Board::firstFreeKick(Vec2i pos, int fromRotation, int direction) const {
+    static_assert(T != TetrominoType::O, "the O piece has no kicks");
+    const unsigned column = static_cast<unsigned>(pos.x - PIECE_COLUMN_MIN);
+    if (column >= PIECE_COLUMN_SPAN) return -1;
+    const KickMask& mask =
+        KICK_MASKS[static_cast<int>(T)][fromRotation & 3][direction > 0][column];
+
+    // Rows above and below the board are full, which rules out every kick
+    // that would leave it vertically
+    const int top = pos.y + mask.top;
+    uint64_t  hit = mask.offBoard;
+    for (int i = 0; i < KICK_WINDOW_ROWS; ++i) {
+        const int      r   = top + i;
+        const uint16_t row = static_cast<unsigned>(r) < BOARD_ROWS_TOTAL ? m_rows[r] : FULL_ROW_MASK;
+        hit |= (row * KICK_LANE_ONES) & mask.rows[i];
+    }
+
+    // Fold each lane onto its top bit (the low nine bits can't carry out of
+    // the lane), then the first free kick is the lowest clear top bit
+    const uint64_t low  = KICK_LANE_HIGH - KICK_LANE_ONES;
+    const uint64_t free = ~(((hit & low) + low) | hit) & KICK_LANE_HIGH;
+    if (!free) return -1;
+    int k = 0;
+    while (!((free >> (BOARD_COLS * k + BOARD_COLS - 1)) & 1u)) ++k;
+    return k;
+}
@@ -0,0 +1,231 @@
+#include "board_batch.h"
+#include <algorithm>
+
+// TETRIS_BATCH_SCALAR forces the portable kernels, so tests can check each
+// kernel set whatever the target supports
+#if TETRIS_BATCH_SCALAR
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define TETRIS_BATCH_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TETRIS_BATCH_SSE2 1
+#endif
+
+// ---------------------------------------------------------------------------
+// 16-lane kernels. Each works on one LANE_BLOCK of uint16 row masks; masks
+// use 0xFFFF for "true" so they can select rows with and/andnot.
+// ---------------------------------------------------------------------------
+
+namespace {
+
+#if TETRIS_BATCH_AVX2
+
+struct Block {
+    __m256i v;
+};
+
+inline Block load(const uint16_t* p)         { return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))}; }
+inline void  store(uint16_t* p, Block b)     { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), b.v); }
+inline Block splat(uint16_t x)               { return {_mm256_set1_epi16(static_cast<short>(x))}; }
+inline Block zero()                          { return {_mm256_setzero_si256()}; }
+inline Block bitOr(Block a, Block b)         { return {_mm256_or_si256(a.v, b.v)}; }
+inline Block bitAnd(Block a, Block b)        { return {_mm256_and_si256(a.v, b.v)}; }
+inline Block equal(Block a, Block b)         { return {_mm256_cmpeq_epi16(a.v, b.v)}; }
+inline Block sub(Block a, Block b)           { return {_mm256_sub_epi16(a.v, b.v)}; }
+inline Block select(Block m, Block a, Block b) {
+    return {_mm256_or_si256(_mm256_and_si256(m.v, a.v), _mm256_andnot_si256(m.v, b.v))};
+}
+inline bool  any(Block m)                    { return !_mm256_testz_si256(m.v, m.v); }
+inline void  storeBytes(uint8_t* out, Block b) {
+    __m128i lo = _mm256_castsi256_si128(b.v);
+    __m128i hi = _mm256_extracti128_si256(b.v, 1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packs_epi16(lo, hi));
+}
+
+#elif TETRIS_BATCH_SSE2
+
+struct Block {
+    __m128i lo, hi;
+};
+
+inline Block load(const uint16_t* p) {
+    return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8))};
+}
+inline void store(uint16_t* p, Block b) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), b.lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p + 8), b.hi);
+}
+inline Block splat(uint16_t x)        { __m128i v = _mm_set1_epi16(static_cast<short>(x)); return {v, v}; }
+inline Block zero()                   { return {_mm_setzero_si128(), _mm_setzero_si128()}; }
+inline Block bitOr(Block a, Block b)  { return {_mm_or_si128(a.lo, b.lo), _mm_or_si128(a.hi, b.hi)}; }
+inline Block bitAnd(Block a, Block b) { return {_mm_and_si128(a.lo, b.lo), _mm_and_si128(a.hi, b.hi)}; }
+inline Block equal(Block a, Block b)  { return {_mm_cmpeq_epi16(a.lo, b.lo), _mm_cmpeq_epi16(a.hi, b.hi)}; }
+inline Block sub(Block a, Block b)    { return {_mm_sub_epi16(a.lo, b.lo), _mm_sub_epi16(a.hi, b.hi)}; }
+inline Block select(Block m, Block a, Block b) {
+    return {_mm_or_si128(_mm_and_si128(m.lo, a.lo), _mm_andnot_si128(m.lo, b.lo)),
+            _mm_or_si128(_mm_and_si128(m.hi, a.hi), _mm_andnot_si128(m.hi, b.hi))};
+}
+inline bool any(Block m) { return _mm_movemask_epi8(_mm_or_si128(m.lo, m.hi)) != 0; }
+inline void storeBytes(uint8_t* out, Block b) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packs_epi16(b.lo, b.hi));
+}
+
+#else
+
+struct Block {
+    uint16_t v[16];
+};
+
+template <typename Fn>
+inline Block map2(Block a, Block b, Fn fn) {
+    Block r;
+    for (int i = 0; i < 16; ++i) r.v[i] = static_cast<uint16_t>(fn(a.v[i], b.v[i]));
+    return r;
+}
+
+inline Block load(const uint16_t* p)     { Block b; std::copy(p, p + 16, b.v); return b; }
+inline void  store(uint16_t* p, Block b) { std::copy(b.v, b.v + 16, p); }
+inline Block splat(uint16_t x)           { Block b; std::fill(b.v, b.v + 16, x); return b; }
+inline Block zero()                      { return splat(0); }
+inline Block bitOr(Block a, Block b)     { return map2(a, b, [](unsigned x, unsigned y) { return x | y; }); }
+inline Block bitAnd(Block a, Block b)    { return map2(a, b, [](unsigned x, unsigned y) { return x & y; }); }
+inline Block equal(Block a, Block b)     { return map2(a, b, [](unsigned x, unsigned y) { return x == y ? 0xFFFFu : 0u; }); }
+inline Block sub(Block a, Block b)       { return map2(a, b, [](unsigned x, unsigned y) { return x - y; }); }
+inline Block select(Block m, Block a, Block b) {
+    Block r;
+    for (int i = 0; i < 16; ++i) r.v[i] = static_cast<uint16_t>((m.v[i] & a.v[i]) | (~m.v[i] & b.v[i]));
+    return r;
+}
+inline bool any(Block m) { return std::any_of(m.v, m.v + 16, [](uint16_t x) { return x != 0; }); }
+inline void storeBytes(uint8_t* out, Block b) {
+    for (int i = 0; i < 16; ++i) out[i] = static_cast<uint8_t>(b.v[i]);
+}
+
+#endif
+
+// Piece row masks shifted onto board columns, or false if the placement
+// leaves the board (identical for every lane)
+struct PlacedPiece {
+    int      top;
+    int      height;
+    uint16_t rows[4];
+};
+
+bool placePiece(TetrominoType type, Vec2i pos, int rotation, PlacedPiece& out) {
+    const ColumnMask* mask = columnMask(type, rotation, pos.x);
+    if (!mask) return false;
+    out.top    = pos.y + mask->top;
+    out.height = pieceMask(type, rotation).height;
+    if (static_cast<unsigned>(out.top) >= mask->topSpan) return false;
+    for (int i = 0; i < out.height; ++i)
+        out.rows[i] = mask->rows[i];
+    return true;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// BoardBatch
+// ---------------------------------------------------------------------------
+
+BoardBatch::BoardBatch(int lanes)
+    : m_lanes(std::max(1, (lanes + LANE_BLOCK - 1) / LANE_BLOCK) * LANE_BLOCK),
+      m_rows(static_cast<size_t>(m_lanes) * BOARD_ROWS_TOTAL, 0)
+{}
+
+const char* BoardBatch::kernelName() {
+#if TETRIS_BATCH_AVX2
+    return "avx2";
+#elif TETRIS_BATCH_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+void BoardBatch::reset() {
+    std::fill(m_rows.begin(), m_rows.end(), 0);
+}
+
+void BoardBatch::setLane(int lane, const Board& board) {
+    for (int r = 0; r < BOARD_ROWS_TOTAL; ++r)
+        row(r)[lane] = board.rowMask(r);
+}
+
+Board BoardBatch::lane(int lane) const {
+    Board board;
+    for (int r = 0; r < BOARD_ROWS_TOTAL; ++r)
+        board.setRow(r, row(r)[lane]);
+    return board;
+}
+
+void BoardBatch::validPositions(TetrominoType type, Vec2i pos, int rotation, uint8_t* out) const {
+    PlacedPiece piece;
+    if (!placePiece(type, pos, rotation, piece)) {
+        std::fill(out, out + m_lanes, uint8_t{0});
+        return;
+    }
+
+    const Block one = splat(1);
+    for (int base = 0; base < m_lanes; base += LANE_BLOCK) {
+        Block hit = zero();
+        for (int i = 0; i < piece.height; ++i)
+            hit = bitOr(hit, bitAnd(load(row(piece.top + i) + base), splat(piece.rows[i])));
+        storeBytes(out + base, bitAnd(equal(hit, zero()), one));
+    }
+}
+
+void BoardBatch::lockPiece(TetrominoType type, Vec2i pos, int rotation, uint8_t* linesCleared) {
+    // Clip to the board like Board::lockPiece, which drops out-of-bounds cells
+    uint16_t add[BOARD_ROWS_TOTAL] = {};
+    int      first = BOARD_ROWS_TOTAL, last = -1;
+    for (const auto& c : Tetromino(type).worldCellsAt(pos, rotation)) {
+        if (c.x < 0 || c.x >= BOARD_COLS || c.y < 0 || c.y >= BOARD_ROWS_TOTAL) continue;
+        add[c.y] |= static_cast<uint16_t>(1u << c.x);
+        first = std::min(first, c.y);
+        last  = std::max(last, c.y);
+    }
+
+    const Block full = splat(FULL_ROW_MASK);
+    for (int base = 0; base < m_lanes; base += LANE_BLOCK) {
+        for (int r = first; r <= last; ++r) {
+            uint16_t* p = row(r) + base;
+            store(p, bitOr(load(p), splat(add[r])));
+        }
+
+        // Only rows the piece touched can be full; each one that is full in
+        // some lane adds one to the most any lane's rows can move
+        int shifts = 0;
+        for (int r = first; r <= last; ++r)
+            shifts += any(equal(load(row(r) + base), full)) ? 1 : 0;
+
+        // Single bottom-up pass like Board::lockPiece. count is each lane's
+        // full rows from src down to last, so a kept row src belongs at
+        // src + count: one masked store per shift some lane needs.
+        Block count = zero();
+        if (shifts > 0) {
+            const Block ones = splat(0xFFFF);
+            for (int src = last; src >= 0; --src) {
+                const Block value  = load(row(src) + base);
+                const Block isFull = src >= first ? equal(value, full) : zero();
+                count = sub(count, isFull); // isFull is -1 per full lane
+                for (int k = 1; k <= std::min(shifts, last - src); ++k) {
+                    const Block write = select(isFull, zero(), equal(count, splat(static_cast<uint16_t>(k))));
+                    if (!any(write)) continue;
+                    uint16_t* dst = row(src + k) + base;
+                    store(dst, select(write, value, load(dst)));
+                }
+            }
+
+            // The top count rows of each lane were vacated
+            Block vacated = select(equal(count, zero()), zero(), ones);
+            for (int r = 0; r < shifts; ++r) {
+                store(row(r) + base, select(vacated, zero(), load(row(r) + base)));
+                vacated = select(equal(count, splat(static_cast<uint16_t>(r + 1))), zero(), vacated);
+            }
+        }
+        if (linesCleared) storeBytes(linesCleared + base, count);
+    }
+}
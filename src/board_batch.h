@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "board.h"
+#include "tetromino.h"
+
+// K boards in struct-of-arrays form for lockstep search: row r of every lane
+// is stored contiguously (rows[r * lanes + lane]), so one SIMD register holds
+// the same row of 16 (AVX2) or 8 (SSE2) boards. Every operation applies one
+// piece placement to all lanes at once and matches Board::isValidPosition /
+// Board::lockPiece lane by lane. Colors are not tracked; lane() returns
+// boards filled with GARBAGE_COLOR.
+class BoardBatch {
+public:
+    static constexpr int LANE_BLOCK = 16; // lanes are allocated in blocks of 16
+
+    // lanes is rounded up to a multiple of LANE_BLOCK; all boards start empty
+    explicit BoardBatch(int lanes);
+
+    int lanes() const { return m_lanes; }
+
+    void  reset();
+    void  setLane(int lane, const Board& board);
+    Board lane(int lane) const;
+
+    uint16_t rowMask(int lane, int row) const { return m_rows[row * m_lanes + lane]; }
+
+    // out[lane] = 1 if the piece fits on that lane's board, else 0
+    void validPositions(TetrominoType type, Vec2i pos, int rotation, uint8_t* out) const;
+
+    // Locks the piece into every lane and clears full rows.
+    // linesCleared[lane] receives that lane's line count (may be nullptr).
+    void lockPiece(TetrominoType type, Vec2i pos, int rotation, uint8_t* linesCleared);
+
+    // Name of the kernel set compiled in: "avx2", "sse2" or "scalar"
+    static const char* kernelName();
+
+private:
+    int                   m_lanes;
+    std::vector<uint16_t> m_rows; // [row][lane]
+
+    uint16_t*       row(int r)       { return m_rows.data() + r * m_lanes; }
+    const uint16_t* row(int r) const { return m_rows.data() + r * m_lanes; }
+};
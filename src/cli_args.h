@@ -0,0 +1,27 @@
+#pragma once
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+
+// Numeric command-line options shared by tetris, tetris_sim and
+// tetris_versus_server.
+
+// Whole-string unsigned decimal in [0, max]; rejects signs, blanks and
+// trailing characters, which strtoul and atoi would let through
+inline bool parseUnsigned(const char* text, unsigned long long max, unsigned long long& out) {
+    if (!std::isdigit(static_cast<unsigned char>(*text))) return false;
+    char* end = nullptr;
+    errno     = 0;
+    out       = std::strtoull(text, &end, 10);
+    return errno == 0 && *end == '\0' && out <= max;
+}
+
+// The same for an int in [min, max], min >= 0
+inline bool parseInt(const char* text, int min, int max, int& out) {
+    unsigned long long value;
+    if (!parseUnsigned(text, static_cast<unsigned long long>(max), value) ||
+        value < static_cast<unsigned long long>(min))
+        return false;
+    out = static_cast<int>(value);
+    return true;
+}
@@ -0,0 +1,81 @@
+#include "evaluator.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Hardware popcount with -mpopcnt / TETRIS_NATIVE; otherwise the builtin
+// becomes a library call and the SWAR version is faster for 16-bit rows
+static inline int popcount16(uint32_t x) {
+#if defined(__POPCNT__) && (defined(__GNUC__) || defined(__clang__))
+    return __builtin_popcount(x);
+#else
+    x = x - ((x >> 1) & 0x5555u);
+    x = (x & 0x3333u) + ((x >> 2) & 0x3333u);
+    x = (x + (x >> 4)) & 0x0F0Fu;
+    return static_cast<int>((x + (x >> 8)) & 0x1Fu);
+#endif
+}
+
+BoardFeatures computeFeatures(const Board& board) {
+    BoardFeatures f;
+
+    int heights[BOARD_COLS];
+    for (int c = 0; c < BOARD_COLS; ++c) {
+        heights[c] = BOARD_ROWS_TOTAL - board.columnTop(c);
+        f.aggregateHeight += heights[c];
+        f.maxHeight = std::max(f.maxHeight, heights[c]);
+    }
+    for (int c = 0; c + 1 < BOARD_COLS; ++c)
+        f.bumpiness += std::abs(heights[c] - heights[c + 1]);
+
+    // A well is a column lower than both neighbours (walls count as infinitely
+    // high); deeper wells cost progressively more
+    for (int c = 0; c < BOARD_COLS; ++c) {
+        const int left  = c > 0              ? heights[c - 1] : BOARD_ROWS_TOTAL;
+        const int right = c + 1 < BOARD_COLS ? heights[c + 1] : BOARD_ROWS_TOTAL;
+        const int depth = std::min(left, right) - heights[c];
+        if (depth > 0) f.wells += depth * (depth + 1) / 2;
+    }
+
+    // Walls are treated as filled: bit 0 and bit BOARD_COLS + 1 around the row
+    constexpr uint32_t WALLS      = 1u | (1u << (BOARD_COLS + 1));
+    constexpr uint32_t EDGE_PAIRS = (1u << (BOARD_COLS + 1)) - 1;
+
+    const int top = BOARD_ROWS_TOTAL - f.maxHeight;
+    uint16_t  holeRows[BOARD_ROWS_TOTAL];
+    uint16_t  above = 0; // columns with a filled cell in some row above
+    uint16_t  prev  = 0;
+    for (int r = top; r < BOARD_ROWS_TOTAL; ++r) {
+        const uint16_t row = board.rowMask(r);
+
+        holeRows[r] = static_cast<uint16_t>(~row & above & FULL_ROW_MASK);
+        f.holes += popcount16(holeRows[r]);
+
+        const uint32_t walled = (static_cast<uint32_t>(row) << 1) | WALLS;
+        f.rowTransitions    += popcount16((walled ^ (walled >> 1)) & EDGE_PAIRS);
+        f.columnTransitions += popcount16(row ^ prev);
+
+        above |= row;
+        prev   = row;
+    }
+    if (top < BOARD_ROWS_TOTAL)
+        f.columnTransitions += popcount16(~prev & FULL_ROW_MASK); // floor
+
+    // Back up: a filled cell is covering if its column has a hole lower down
+    uint16_t holeBelow = 0;
+    for (int r = BOARD_ROWS_TOTAL - 1; r >= top; --r) {
+        f.coveredCells += popcount16(board.rowMask(r) & holeBelow);
+        holeBelow |= holeRows[r];
+    }
+    return f;
+}
+
+float evaluate(const BoardFeatures& f, const EvalWeights& w) {
+    return w.aggregateHeight   * f.aggregateHeight
+         + w.maxHeight         * f.maxHeight
+         + w.holes             * f.holes
+         + w.coveredCells      * f.coveredCells
+         + w.bumpiness         * f.bumpiness
+         + w.rowTransitions    * f.rowTransitions
+         + w.columnTransitions * f.columnTransitions
+         + w.wells             * f.wells;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "board.h"
+
+// Stack shape features used to score placements. Heights count from the
+// floor; the hidden spawn rows are part of the stack like any other row.
+struct BoardFeatures {
+    int aggregateHeight   = 0; // sum of column heights
+    int maxHeight         = 0;
+    int holes             = 0; // empty cells with a filled cell above
+    int coveredCells      = 0; // filled cells with a hole somewhere below
+    int bumpiness         = 0; // sum of |height difference| of adjacent columns
+    int rowTransitions    = 0; // filled/empty changes along rows, walls filled
+    int columnTransitions = 0; // filled/empty changes down columns, floor filled
+    int wells             = 0; // sum of 1 + 2 + ... + depth over every well
+};
+
+// Two passes over the row masks below the stack top: down for holes and
+// transitions, then back up for covered cells, which need to know what lies
+// below. Popcounts per row; no per-cell loops.
+BoardFeatures computeFeatures(const Board& board);
+
+// Linear evaluation weights; lines rewards the lines cleared by the
+// placement(s) that produced the board
+struct EvalWeights {
+    float aggregateHeight   = -0.35f;
+    float maxHeight         = -0.20f;
+    float holes             = -4.00f;
+    float coveredCells      = -0.60f;
+    float bumpiness         = -0.25f;
+    float rowTransitions    = -0.80f;
+    float columnTransitions = -1.20f;
+    float wells             = -0.30f;
+    float lines[5]          = {0.0f, -1.0f, -0.5f, 0.5f, 6.0f};
+};
+
+float evaluate(const BoardFeatures& features, const EvalWeights& weights);
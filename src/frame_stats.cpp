@@ -0,0 +1,119 @@
+#include "frame_stats.h"
+#include <algorithm>
+#include <cstdio>
+
+const char* framePhaseName(FramePhase phase) {
+    switch (phase) {
+        case FramePhase::Events:       return "events";
+        case FramePhase::Draw:         return "draw";
+        case FramePhase::Display:      return "display";
+        case FramePhase::Frame:        return "frame";
+        case FramePhase::SimTick:      return "sim_tick";
+        case FramePhase::InputLatency: return "input_latency";
+        default:                       return "?";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// TimingHistogram
+// ---------------------------------------------------------------------------
+
+void TimingHistogram::add(int64_t micros) {
+    micros = std::max<int64_t>(0, micros);
+    int bucket = static_cast<int>(std::min<int64_t>(micros / BUCKET_US, BUCKETS - 1));
+    ++m_buckets[bucket];
+    ++m_count;
+    m_max = std::max(m_max, micros);
+}
+
+void TimingHistogram::clear() {
+    m_buckets.fill(0);
+    m_count = 0;
+    m_max   = 0;
+}
+
+int64_t TimingHistogram::percentileUs(double p) const {
+    if (m_count == 0) return 0;
+    const int64_t rank = std::max<int64_t>(1, static_cast<int64_t>(p * m_count + 0.5));
+    int64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank)
+            return std::min<int64_t>(static_cast<int64_t>(i + 1) * BUCKET_US, m_max);
+    }
+    return m_max;
+}
+
+// ---------------------------------------------------------------------------
+// FrameStats
+// ---------------------------------------------------------------------------
+
+static int64_t microsBetween(FrameStats::Clock::time_point a, FrameStats::Clock::time_point b) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(b - a).count();
+}
+
+void FrameStats::beginFrame() {
+    m_frameStart = m_lastMark = Clock::now();
+}
+
+void FrameStats::endPhase(FramePhase phase) {
+    const auto now = Clock::now();
+    m_histograms[static_cast<int>(phase)].add(microsBetween(m_lastMark, now));
+    m_lastMark = now;
+}
+
+void FrameStats::endFrame(uint64_t keysApplied) {
+    const auto now = Clock::now();
+    m_histograms[static_cast<int>(FramePhase::Frame)].add(microsBetween(m_frameStart, now));
+    if (m_pressPending && keysApplied >= m_pressKey) {
+        m_histograms[static_cast<int>(FramePhase::InputLatency)].add(microsBetween(m_pressTime, now));
+        m_pressPending = false;
+    }
+}
+
+void FrameStats::notePress(uint64_t key) {
+    if (m_pressPending) return;
+    m_pressTime    = Clock::now();
+    m_pressKey     = key;
+    m_pressPending = true;
+}
+
+void FrameStats::addTicks(const TickSamples& ticks) {
+    // Only the last CAPACITY ticks are still in the window
+    const uint64_t window = std::min<uint64_t>(ticks.count, TickSamples::CAPACITY);
+    const uint64_t first  = std::max(m_ticksSeen, ticks.count - window);
+    auto&          histogram = m_histograms[static_cast<int>(FramePhase::SimTick)];
+    for (uint64_t t = first; t < ticks.count; ++t)
+        histogram.add(ticks.micros[t % TickSamples::CAPACITY]);
+    m_ticksSeen = ticks.count;
+}
+
+std::string FrameStats::summary() const {
+    std::string out;
+    char line[96];
+    for (int i = 0; i < FRAME_PHASE_COUNT; ++i) {
+        const auto& h = m_histograms[i];
+        std::snprintf(line, sizeof(line), "%-14s p50 %6.2f  p99 %6.2f ms\n",
+                      framePhaseName(static_cast<FramePhase>(i)),
+                      h.percentileUs(0.50) / 1000.0, h.percentileUs(0.99) / 1000.0);
+        out += line;
+    }
+    return out;
+}
+
+bool FrameStats::writeCsv(const std::string& path) const {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+
+    std::fprintf(file, "phase,bucket_start_us,bucket_end_us,count\n");
+    for (int i = 0; i < FRAME_PHASE_COUNT; ++i) {
+        const auto& h = m_histograms[i];
+        for (int b = 0; b < TimingHistogram::BUCKETS; ++b) {
+            if (!h.bucket(b)) continue;
+            std::fprintf(file, "%s,%d,%d,%lld\n", framePhaseName(static_cast<FramePhase>(i)),
+                         b * TimingHistogram::BUCKET_US, (b + 1) * TimingHistogram::BUCKET_US,
+                         static_cast<long long>(h.bucket(b)));
+        }
+    }
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Phases of one main-loop iteration, timed separately
+enum class FramePhase {
+    Events,       // window.pollEvent loop, forwarding keys to the simulation thread
+    Draw,         // clear + Renderer::drawAll
+    Display,      // window.display (includes vsync / frame limiter wait)
+    Frame,        // whole iteration
+    SimTick,      // one simulation tick: key drain, InputHandler::update, Game::step
+    InputLatency, // key event polled -> first presented frame whose state reflects it
+    Count
+};
+
+constexpr int FRAME_PHASE_COUNT = static_cast<int>(FramePhase::Count);
+
+const char* framePhaseName(FramePhase phase);
+
+// Fixed-size linear histogram: 20 us buckets up to 100 ms, with the last
+// bucket collecting anything slower. Never allocates after construction.
+class TimingHistogram {
+public:
+    static constexpr int BUCKET_US = 20;
+    static constexpr int BUCKETS   = 5000;
+
+    void add(int64_t micros);
+    void clear();
+
+    int64_t count()  const { return m_count; }
+    int64_t maxUs()  const { return m_max; }
+
+    // Upper edge of the bucket holding the p-th percentile (p in [0, 1])
+    int64_t percentileUs(double p) const;
+
+    int64_t bucket(int i) const { return m_buckets[i]; }
+
+private:
+    std::array<uint32_t, BUCKETS> m_buckets{};
+    int64_t                       m_count = 0;
+    int64_t                       m_max   = 0;
+};
+
+// Tick durations as published by the simulation thread: a running count plus
+// the most recent CAPACITY samples, so a reader that only sees every few
+// publishes still picks up each tick it hasn't counted yet
+struct TickSamples {
+    static constexpr int CAPACITY = 32;
+
+    uint64_t                       count = 0;
+    std::array<uint32_t, CAPACITY> micros{};
+
+    void add(int64_t us) {
+        micros[count % CAPACITY] = static_cast<uint32_t>(us < 0 ? 0 : us);
+        ++count;
+    }
+};
+
+// Per-phase frame timing for the main loop. Call beginFrame() at the top of
+// the loop, endPhase() after each phase and endFrame() after display.
+// Latency is measured from the moment a key press is pulled off the event
+// queue, so it excludes OS queueing before the poll, and ends at the first
+// frame drawn from a simulation state that has applied that key.
+class FrameStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void beginFrame();
+    void endPhase(FramePhase phase);
+
+    // keysApplied: sequence number of the last key event the presented
+    // state reflects
+    void endFrame(uint64_t keysApplied);
+
+    // Call when a key press is polled with the sequence number it was sent
+    // to the simulation under; only the first press awaiting a frame counts
+    void notePress(uint64_t key);
+
+    // Adds the SimTick samples published since the previous call. Ticks that
+    // fell out of the sample window between two calls are lost.
+    void addTicks(const TickSamples& ticks);
+
+    const TimingHistogram& histogram(FramePhase phase) const {
+        return m_histograms[static_cast<int>(phase)];
+    }
+
+    // One-line p50/p99 summary per phase, for the on-screen overlay
+    std::string summary() const;
+
+    // phase,bucket_start_us,bucket_end_us,count for every non-empty bucket
+    bool writeCsv(const std::string& path) const;
+
+private:
+    std::array<TimingHistogram, FRAME_PHASE_COUNT> m_histograms;
+
+    Clock::time_point m_frameStart;
+    Clock::time_point m_lastMark;
+    Clock::time_point m_pressTime;
+    uint64_t          m_pressKey     = 0;
+    bool              m_pressPending = false;
+    uint64_t          m_ticksSeen    = 0;
+};
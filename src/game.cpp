@@ -1,10 +1,17 @@
 #include "game.h"
+#include "bag.h"
+#include "replay.h"
+#include "zobrist.h"
 #include <algorithm>
 #include <cmath>
+#include <random>
 
 // NES-style line clear score multipliers
 static constexpr int LINE_MULTIPLIERS[] = {0, 40, 100, 300, 1200};
 
+// Versus attack per lines cleared
+static constexpr int GARBAGE_SENT[] = {0, 0, 1, 2, 4};
+
 // Gravity intervals from Tetris Guideline (seconds per row)
 float Game::gravityInterval(int level) const {
     if (level <= 0) level = 1;
@@ -14,13 +21,23 @@ float Game::gravityInterval(int level) const {
     return std::pow(base, level - 1);
 }
 
+// Converts seconds-per-row into fixed-point rows per tick (at least 1/65536)
+uint32_t Game::gravityPerTick(float interval) const {
+    double perTick = GRAVITY_ONE / (static_cast<double>(interval) * m_tickRate);
+    return std::max<uint32_t>(1, static_cast<uint32_t>(std::lround(perTick)));
+}
+
 // ---------------------------------------------------------------------------
 // Construction / reset
 // ---------------------------------------------------------------------------
 
-Game::Game() {
-    std::random_device rd;
-    m_rng.seed(rd());
+Game::Game() : Game(std::random_device{}()) {}
+
+Game::Game(uint32_t seed, int tickRate)
+    : m_seed(seed), m_tickRate(std::clamp(tickRate, 1, MAX_TICK_RATE))
+{
+    m_softDropPerTick = gravityPerTick(0.05f);
+    m_lockDelayTicks   = std::max(1, m_tickRate / 2); // 0.5 s
     reset();
 }
 
@@ -29,24 +46,23 @@ void Game::reset() {
     m_held.reset();
     m_holdUsed = false;
     m_score    = {};
-    m_state    = GameState::Playing;
+    m_pieces   = 0;
 
-    m_gravityAccum    = 0.f;
-    m_gravityInterval = gravityInterval(1);
-    m_lockTimer       = 0.f;
-    m_onGround        = false;
+    m_garbageIn  = 0;
+    m_garbageOut = 0;
+    m_state      = GameState::Playing;
+
+    m_gravityAccum   = 0;
+    m_gravityPerTick = gravityPerTick(gravityInterval(1));
+    m_lockTicks      = 0;
+    m_onGround       = false;
 
     // Initialize both halves with shuffled bags
     m_bagIndex = 0;
-    std::array<TetrominoType, 7> types = {
-        TetrominoType::I, TetrominoType::J, TetrominoType::L,
-        TetrominoType::O, TetrominoType::S, TetrominoType::T,
-        TetrominoType::Z
-    };
-    std::shuffle(types.begin(), types.end(), m_rng);
-    for (int i = 0; i < 7; ++i) m_bag[i] = types[i];
-    std::shuffle(types.begin(), types.end(), m_rng);
-    for (int i = 0; i < 7; ++i) m_bag[i + 7] = types[i];
+    m_bagCount = 2;
+    const Bag first = bagAt(m_seed, 0), second = bagAt(m_seed, 1);
+    std::copy(first.begin(), first.end(), m_bag.begin());
+    std::copy(second.begin(), second.end(), m_bag.begin() + 7);
 
     spawnPiece(drawFromBag());
 }
@@ -60,15 +76,9 @@ void Game::refillBag() {
     for (int i = 0; i < 7; ++i)
         m_bag[i] = m_bag[i + 7];
 
-    // Refill second half with a fresh shuffle
-    std::array<TetrominoType, 7> fresh = {
-        TetrominoType::I, TetrominoType::J, TetrominoType::L,
-        TetrominoType::O, TetrominoType::S, TetrominoType::T,
-        TetrominoType::Z
-    };
-    std::shuffle(fresh.begin(), fresh.end(), m_rng);
-    for (int i = 0; i < 7; ++i)
-        m_bag[i + 7] = fresh[i];
+    // Refill second half with the next bag
+    const Bag fresh = bagAt(m_seed, m_bagCount++);
+    std::copy(fresh.begin(), fresh.end(), m_bag.begin() + 7);
 }
 
 TetrominoType Game::drawFromBag() {
@@ -87,21 +97,38 @@ std::array<TetrominoType, 3> Game::nextPieces() const {
     return next;
 }
 
+uint64_t Game::dealt() const {
+    return static_cast<uint64_t>(m_bagCount - 2) * 7 + static_cast<uint64_t>(m_bagIndex);
+}
+
+void Game::peekPieces(TetrominoType* out, int count) const {
+    // The buffered bags cover the first 7-13 pieces; the rest come straight
+    // from the sequence, one bag computation per 7 pieces
+    const int buffered = std::min(count, static_cast<int>(m_bag.size()) - m_bagIndex);
+    for (int i = 0; i < buffered; ++i)
+        out[i] = m_bag[m_bagIndex + i];
+
+    int i = buffered;
+    for (uint32_t n = m_bagCount; i < count; ++n) {
+        const Bag bag = bagAt(m_seed, n);
+        for (int k = 0; k < 7 && i < count; ++k) out[i++] = bag[k];
+    }
+}
+
 // ---------------------------------------------------------------------------
 // Piece management
 // ---------------------------------------------------------------------------
 
 void Game::spawnPiece(TetrominoType type) {
-    m_current = std::make_unique<Tetromino>(type);
+    m_current = Tetromino(type);
     // Spawn at top-center (hidden rows 0-1, visible starts at row 2)
-    int spawnCol = BOARD_COLS / 2 - 1; // col 4 for 10-wide board
-    m_current->setPosition({spawnCol, 1});
+    m_current.setPosition(SPAWN_POSITION);
 
-    m_lockTimer = 0.f;
+    m_lockTicks = 0;
     m_onGround  = false;
 
     // Game over if spawn position is already blocked
-    if (!m_board.isValidPosition(*m_current, m_current->position(), 0)) {
+    if (!m_board.isValidPosition(m_current, m_current.position(), 0)) {
         m_state = GameState::GameOver;
     }
 
@@ -109,60 +136,185 @@ void Game::spawnPiece(TetrominoType type) {
 }
 
 void Game::updateGhost() {
-    m_ghostRow = m_board.ghostDropDistance(*m_current);
+    m_ghostRow = m_board.ghostDropDistance(m_current);
 }
 
 bool Game::isOnGround() const {
-    return !m_board.isValidPosition(*m_current,
-                                    m_current->position() + sf::Vector2i{0, 1},
-                                    m_current->rotationState());
+    return !m_board.isValidPosition(m_current,
+                                    m_current.position() + Vec2i{0, 1},
+                                    m_current.rotationState());
+}
+
+// ---------------------------------------------------------------------------
+// Hashing
+// ---------------------------------------------------------------------------
+
+namespace {
+// Queue slot 0 is the current piece, then the bag in draw order; type 7 in the
+// hold slot means empty
+struct GameKeys {
+    uint64_t queue[15][7];
+    uint64_t hold[8];
+    uint64_t holdUsed;
+};
+
+GameKeys buildGameKeys() {
+    GameKeys keys{};
+    uint64_t state = 0x5EED6A3E0B1D2ull;
+    for (auto& slot : keys.queue)
+        for (auto& k : slot) k = splitMix64(state);
+    for (auto& k : keys.hold) k = splitMix64(state);
+    keys.holdUsed = splitMix64(state);
+    return keys;
+}
+
+const GameKeys GAME_KEYS = buildGameKeys();
+} // namespace
+
+uint64_t Game::hash() const {
+    uint64_t h = m_board.hash();
+    h ^= GAME_KEYS.queue[0][static_cast<int>(m_current.type())];
+    for (int i = m_bagIndex; i < static_cast<int>(m_bag.size()); ++i)
+        h ^= GAME_KEYS.queue[1 + i - m_bagIndex][static_cast<int>(m_bag[i])];
+    h ^= GAME_KEYS.hold[m_held ? static_cast<int>(m_held->type()) : 7];
+    if (m_holdUsed) h ^= GAME_KEYS.holdUsed;
+    return h;
+}
+
+// ---------------------------------------------------------------------------
+// Snapshots
+// ---------------------------------------------------------------------------
+
+// GameSnapshot::queue layout. Bag slot 0 is never read again once the first
+// piece is drawn (m_bagIndex is 1-7 between steps), so slots 1-13 suffice.
+namespace {
+constexpr int Q_BAG      = 0;  // 13 x 3 bits
+constexpr int Q_INDEX    = 39; // 3 bits
+constexpr int Q_HELD     = 42; // 3 bits, 7 = empty
+constexpr int Q_HOLDUSED = 45; // 1 bit
+constexpr int Q_STATE    = 46; // 2 bits
+constexpr int Q_TYPE     = 48; // 3 bits
+constexpr int Q_ROTATION = 51; // 2 bits
+constexpr int Q_X        = 53; // 5 bits, biased by Q_BIAS
+constexpr int Q_Y        = 58; // 5 bits, biased by Q_BIAS
+constexpr int Q_BIAS     = 8;
+
+constexpr uint64_t pack(uint64_t value, int shift) { return value << shift; }
+constexpr int      unpack(uint64_t word, int shift, int bits) {
+    return static_cast<int>((word >> shift) & ((1u << bits) - 1));
+}
+} // namespace
+
+GameSnapshot Game::snapshot() const {
+    GameSnapshot snap{};
+    snap.board = m_board.snapshot();
+
+    uint64_t q = 0;
+    for (int i = 1; i < 14; ++i)
+        q |= pack(static_cast<uint64_t>(m_bag[i]), Q_BAG + 3 * (i - 1));
+    q |= pack(static_cast<uint64_t>(m_bagIndex), Q_INDEX);
+    q |= pack(m_held ? static_cast<uint64_t>(m_held->type()) : 7u, Q_HELD);
+    q |= pack(m_holdUsed ? 1u : 0u, Q_HOLDUSED);
+    q |= pack(static_cast<uint64_t>(m_state), Q_STATE);
+    q |= pack(static_cast<uint64_t>(m_current.type()), Q_TYPE);
+    q |= pack(static_cast<uint64_t>(m_current.rotationState()), Q_ROTATION);
+    q |= pack(static_cast<uint64_t>(m_current.position().x + Q_BIAS), Q_X);
+    q |= pack(static_cast<uint64_t>(m_current.position().y + Q_BIAS), Q_Y);
+    snap.queue = q;
+
+    snap.bagCount     = m_bagCount;
+    snap.score        = m_score.score;
+    snap.lines        = static_cast<uint32_t>(m_score.lines);
+    snap.pieces       = static_cast<uint32_t>(m_pieces);
+    snap.gravityAccum = static_cast<uint16_t>(m_gravityAccum);
+    snap.lockTicks    = static_cast<uint16_t>(m_lockTicks);
+    snap.combo        = static_cast<uint8_t>(m_score.combo);
+    snap.garbageIn    = static_cast<uint8_t>(m_garbageIn);
+    snap.garbageOut   = static_cast<uint8_t>(m_garbageOut);
+    return snap;
+}
+
+void Game::restore(const GameSnapshot& snap) {
+    m_board.restore(snap.board);
+
+    const uint64_t q = snap.queue;
+    for (int i = 1; i < 14; ++i)
+        m_bag[i] = static_cast<TetrominoType>(unpack(q, Q_BAG + 3 * (i - 1), 3));
+    m_bag[0]    = m_bag[1];
+    m_bagIndex  = unpack(q, Q_INDEX, 3);
+    m_bagCount  = snap.bagCount;
+
+    const int held = unpack(q, Q_HELD, 3);
+    if (held == 7) m_held.reset();
+    else           m_held.emplace(static_cast<TetrominoType>(held));
+    m_holdUsed = unpack(q, Q_HOLDUSED, 1) != 0;
+    m_state    = static_cast<GameState>(unpack(q, Q_STATE, 2));
+
+    m_current = Tetromino(static_cast<TetrominoType>(unpack(q, Q_TYPE, 3)));
+    m_current.setRotation(unpack(q, Q_ROTATION, 2));
+    m_current.setPosition({unpack(q, Q_X, 5) - Q_BIAS, unpack(q, Q_Y, 5) - Q_BIAS});
+
+    // The level is always lines / 10 + 1; gravity only needs recomputing
+    // when it differs from the level this Game was last at
+    const int level = static_cast<int>(snap.lines / 10) + 1;
+    if (level != m_score.level)
+        m_gravityPerTick = gravityPerTick(gravityInterval(level));
+    m_score.score = snap.score;
+    m_score.lines = static_cast<int>(snap.lines);
+    m_score.level = level;
+    m_score.combo = snap.combo;
+    m_pieces      = static_cast<int>(snap.pieces);
+
+    m_gravityAccum = snap.gravityAccum;
+    m_lockTicks    = snap.lockTicks;
+    m_garbageIn    = snap.garbageIn;
+    m_garbageOut   = snap.garbageOut;
+
+    m_onGround = isOnGround();
+    updateGhost();
 }
 
 // ---------------------------------------------------------------------------
 // Movement
 // ---------------------------------------------------------------------------
 
-void Game::tryMove(int dx, int dy) {
-    sf::Vector2i newPos = m_current->position() + sf::Vector2i{dx, dy};
-    if (m_board.isValidPosition(*m_current, newPos, m_current->rotationState())) {
-        m_current->setPosition(newPos);
-        if (dy == 0) m_lockTimer = 0.f; // move reset on lateral movement
-        updateGhost();
-    }
+bool Game::tryMove(int dx, int dy) {
+    Vec2i newPos = m_current.position() + Vec2i{dx, dy};
+    if (!m_board.isValidPosition(m_current, newPos, m_current.rotationState()))
+        return false;
+    m_current.setPosition(newPos);
+    if (dy == 0) m_lockTicks = 0; // move reset on lateral movement
+    updateGhost();
+    return true;
 }
 
 void Game::tryRotate(int direction) {
-    int fromState = m_current->rotationState();
-    int toState   = (fromState + direction + 4) % 4;
+    withPieceType(m_current.type(), [&](auto type) {
+        tryRotateAs<decltype(type)::value>(direction);
+    });
+}
 
+template <TetrominoType T>
+void Game::tryRotateAs(int direction) {
     // O-piece: skip rotation
-    if (m_current->type() == TetrominoType::O) return;
-
-    const KickData* kickData = nullptr;
-    if (m_current->type() == TetrominoType::I) {
-        kickData = (direction > 0) ? &SRS_KICKS_I_CW : &SRS_KICKS_I_CCW;
+    if constexpr (T == TetrominoType::O) {
+        (void)direction;
     } else {
-        kickData = (direction > 0) ? &SRS_KICKS_JLSTZ_CW : &SRS_KICKS_JLSTZ_CCW;
-    }
-
-    for (int k = 0; k < 5; ++k) {
-        int kx = kickData->offsets[fromState][k][0];
-        int ky = kickData->offsets[fromState][k][1];
-        sf::Vector2i testPos = m_current->position() + sf::Vector2i{kx, ky};
-        if (m_board.isValidPosition(*m_current, testPos, toState)) {
-            m_current->setPosition(testPos);
-            m_current->setRotation(toState);
-            m_lockTimer = 0.f; // move reset
-            updateGhost();
-            return;
-        }
+        const int fromState = m_current.rotationState();
+        const int kick      = m_board.firstFreeKick<T>(m_current.position(), fromState, direction);
+        if (kick < 0) return; // All kicks failed — rotation is silent no-op
+
+        const auto& offset = PIECE_KICKS<T>[direction > 0]->offsets[fromState][kick];
+        m_current.setPosition(m_current.position() + Vec2i{offset[0], offset[1]});
+        m_current.setRotation(fromState + direction);
+        m_lockTicks = 0; // move reset
+        updateGhost();
     }
-    // All kicks failed — rotation is silent no-op
 }
 
 void Game::hardDrop() {
-    int dist = m_board.ghostDropDistance(*m_current);
-    m_current->setPosition(m_current->position() + sf::Vector2i{0, dist});
+    int dist = m_board.ghostDropDistance(m_current);
+    m_current.setPosition(m_current.position() + Vec2i{0, dist});
     // Hard drop scoring: 2 points per row
     m_score.score += 2 * dist;
     lockCurrent();
@@ -176,16 +328,16 @@ void Game::activateHold() {
     if (m_holdUsed) return;
     m_holdUsed = true;
 
-    TetrominoType currentType = m_current->type();
+    TetrominoType currentType = m_current.type();
 
     if (!m_held) {
         // First hold: stash current, spawn next from bag
-        m_held = std::make_unique<Tetromino>(currentType);
+        m_held.emplace(currentType);
         spawnPiece(drawFromBag());
     } else {
         // Swap current with held
         TetrominoType swapType = m_held->type();
-        m_held = std::make_unique<Tetromino>(currentType);
+        m_held.emplace(currentType);
         spawnPiece(swapType);
     }
 }
@@ -195,10 +347,39 @@ void Game::activateHold() {
 // ---------------------------------------------------------------------------
 
 void Game::lockCurrent() {
-    int cleared = m_board.lockPiece(*m_current);
+    int cleared = m_board.lockPiece(m_current);
+    ++m_pieces;
     addScore(cleared);
     m_holdUsed = false; // allow hold again on new piece
+
+    const int sent   = GARBAGE_SENT[std::min(cleared, 4)];
+    const int cancel = std::min(sent, m_garbageIn);
+    m_garbageIn  -= cancel;
+    m_garbageOut  = std::min(m_garbageOut + sent - cancel, MAX_GARBAGE);
+
+    bool garbageFits = true;
+    if (cleared == 0 && m_garbageIn > 0) {
+        // At most one garbage drop per lock, so (seed, pieces) picks the hole
+        // without any generator state to carry around
+        uint64_t  state = (static_cast<uint64_t>(m_seed) << 32) ^ static_cast<uint32_t>(m_pieces) ^
+                          0x6A5D39EAE116586Dull;
+        const int hole  = static_cast<int>(splitMix64(state) % BOARD_COLS);
+        garbageFits = m_board.addGarbage(m_garbageIn, hole);
+        m_garbageIn = 0;
+    }
+
     spawnPiece(drawFromBag());
+    if (!garbageFits) m_state = GameState::GameOver;
+}
+
+void Game::receiveGarbage(int lines) {
+    if (lines > 0) m_garbageIn = std::min(m_garbageIn + lines, MAX_GARBAGE);
+}
+
+int Game::takeOutgoingGarbage() {
+    const int out = m_garbageOut;
+    m_garbageOut  = 0;
+    return out;
 }
 
 void Game::addScore(int lines) {
@@ -213,19 +394,21 @@ void Game::addScore(int lines) {
     m_score.lines += lines;
     int newLevel = m_score.lines / 10 + 1;
     if (newLevel > m_score.level) {
-        m_score.level     = newLevel;
-        m_gravityInterval = gravityInterval(newLevel);
+        m_score.level    = newLevel;
+        m_gravityPerTick = gravityPerTick(gravityInterval(newLevel));
     }
 }
 
 // ---------------------------------------------------------------------------
-// Main update
+// Fixed-step simulation
 // ---------------------------------------------------------------------------
 
-bool Game::update(InputHandler& input, float dt) {
-    if (input.isJustPressed(Action::Quit)) return false;
+bool Game::step(uint16_t actions) {
+    if (m_recorder) m_recorder->record(actions);
+
+    if (hasAction(actions, Action::Quit)) return false;
 
-    if (input.isJustPressed(Action::Pause)) {
+    if (hasAction(actions, Action::Pause)) {
         if (m_state == GameState::Playing)
             m_state = GameState::Paused;
         else if (m_state == GameState::Paused)
@@ -233,47 +416,49 @@ bool Game::update(InputHandler& input, float dt) {
     }
 
     if (m_state == GameState::GameOver) {
-        if (input.isJustPressed(Action::HardDrop)) reset();
+        if (hasAction(actions, Action::HardDrop)) reset();
         return true;
     }
 
     if (m_state == GameState::Paused) return true;
 
     // --- Input ---
-    if (input.isActive(Action::MoveLeft))  tryMove(-1, 0);
-    if (input.isActive(Action::MoveRight)) tryMove( 1, 0);
-    if (input.isJustPressed(Action::RotateCW))  tryRotate( 1);
-    if (input.isJustPressed(Action::RotateCCW)) tryRotate(-1);
-    if (input.isJustPressed(Action::Hold))      activateHold();
-    if (input.isJustPressed(Action::HardDrop))  { hardDrop(); return true; }
-
-    // Soft drop: accelerate gravity
-    float effectiveInterval = m_gravityInterval;
-    if (input.isHeld(Action::SoftDrop)) {
-        effectiveInterval = std::min(effectiveInterval, 0.05f);
-        m_score.score += 1; // 1 point per soft-drop row (handled via gravity below)
-    }
+    const int repeats = moveRepeats(actions);
+    if (hasAction(actions, Action::MoveLeft))
+        for (int i = 0; i < repeats && tryMove(-1, 0); ++i) {}
+    if (hasAction(actions, Action::MoveRight))
+        for (int i = 0; i < repeats && tryMove( 1, 0); ++i) {}
+    if (hasAction(actions, Action::RotateCW))  tryRotate( 1);
+    if (hasAction(actions, Action::RotateCCW)) tryRotate(-1);
+    if (hasAction(actions, Action::Hold))      activateHold();
+    if (hasAction(actions, Action::HardDrop))  { hardDrop(); return true; }
+
+    // Soft drop: accelerate gravity, 1 point per soft-dropped row
+    bool     softDrop = hasAction(actions, Action::SoftDrop);
+    uint32_t rate     = m_gravityPerTick;
+    if (softDrop) rate = std::max(rate, m_softDropPerTick);
 
     // --- Gravity ---
-    m_gravityAccum += dt;
-    while (m_gravityAccum >= effectiveInterval) {
-        m_gravityAccum -= effectiveInterval;
-        sf::Vector2i below = m_current->position() + sf::Vector2i{0, 1};
-        if (m_board.isValidPosition(*m_current, below, m_current->rotationState())) {
-            m_current->setPosition(below);
-            updateGhost();
-        }
+    m_gravityAccum += rate;
+    int rows = static_cast<int>(m_gravityAccum / GRAVITY_ONE);
+    m_gravityAccum %= GRAVITY_ONE;
+    for (int i = 0; i < rows; ++i) {
+        Vec2i below = m_current.position() + Vec2i{0, 1};
+        if (!m_board.isValidPosition(m_current, below, m_current.rotationState()))
+            break;
+        m_current.setPosition(below);
+        if (softDrop) m_score.score += 1;
+        updateGhost();
     }
 
     // --- Lock delay ---
     m_onGround = isOnGround();
     if (m_onGround) {
-        m_lockTimer += dt;
-        if (m_lockTimer >= m_lockDelay) {
+        if (++m_lockTicks >= m_lockDelayTicks) {
             lockCurrent();
         }
     } else {
-        m_lockTimer = 0.f;
+        m_lockTicks = 0;
     }
 
     return true;
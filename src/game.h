@@ -1,13 +1,15 @@
 #pragma once
-#include <SFML/System.hpp>
-#include <memory>
+#include <cstdint>
 #include <optional>
 #include <array>
-#include <random>
+#include <type_traits>
 #include "board.h"
 #include "tetromino.h"
-#include "input.h"
+#include "action.h"
 
+class ReplayRecorder;
+
+// Sent as a byte by versus_protocol, which rejects anything past GameOver
 enum class GameState {
     Playing,
     Paused,
@@ -21,64 +23,153 @@ struct ScoreState {
     int combo = 0;
 };
 
+// Everything that evolves while a Game plays, packed into one cache line for
+// clone-and-search: copy the struct freely and restore() it into any Game
+// built with the same seed and tick rate. Board colors are not included.
+struct GameSnapshot {
+    BoardSnapshot board;        // 32 B
+    uint64_t      queue;        // bag slots 1-13 (3 bits each), bag index, hold, state, piece
+    uint32_t      bagCount;     // bags shuffled so far
+    int32_t       score;
+    uint32_t      lines;
+    uint32_t      pieces;
+    uint16_t      gravityAccum; // < GRAVITY_ONE
+    uint16_t      lockTicks;    // <= lock delay
+    uint8_t       combo;        // a combo needs a cleared row per piece, so stays small
+    uint8_t       garbageIn;    // both garbage counters saturate at MAX_GARBAGE
+    uint8_t       garbageOut;
+};
+
+static_assert(std::is_trivially_copyable<GameSnapshot>::value, "GameSnapshot must stay POD");
+static_assert(sizeof(GameSnapshot) <= 64, "GameSnapshot should fit one cache line");
+
 class Game {
 public:
     static constexpr int CELL_PX = 32;
 
+    // Simulation ticks per second; gravity and lock delay are counted in ticks
+    static constexpr int DEFAULT_TICK_RATE = 60;
+    static constexpr int MAX_TICK_RATE     = 10000;
+
+    // Queued incoming and unsent outgoing garbage saturate here; anything
+    // past BOARD_ROWS_TOTAL tops out the receiver anyway
+    static constexpr int MAX_GARBAGE = 255;
+
+    // Seeds the bag randomizer from std::random_device
     Game();
 
+    // Fully deterministic: the same seed and step() inputs replay the same game
+    explicit Game(uint32_t seed, int tickRate = DEFAULT_TICK_RATE);
+
     void reset();
 
-    // Returns false when the game requests the window to close (Quit action)
-    bool update(InputHandler& input, float dt);
+    // Advances exactly one fixed tick. actions: bitmask of actionBit(Action)
+    // applied this tick (SoftDrop is level-triggered, everything else fires
+    // once; moves repeat per withMoveRepeats). Returns false when the game
+    // requests the window to close (Quit)
+    bool step(uint16_t actions);
+
+    // Every subsequent step() mask is appended to recorder (nullptr to stop).
+    // Attach before the first step() so the replay starts from the seed.
+    // Copies of the Game share the recorder; detach it before cloning.
+    void setRecorder(ReplayRecorder* recorder) { m_recorder = recorder; }
 
     // Read-only accessors for Renderer
     const Board&      board()    const { return m_board; }
-    const Tetromino&  current()  const { return *m_current; }
+    const Tetromino&  current()  const { return m_current; }
     const ScoreState& score()    const { return m_score; }
     GameState         state()    const { return m_state; }
+    uint32_t          seed()     const { return m_seed; }
+    int               pieces()   const { return m_pieces; } // locked since reset
+    int               tickRate() const { return m_tickRate; }
     int               ghostRow() const { return m_ghostRow; }
     bool              holdUsed() const { return m_holdUsed; }
 
     // nullptr if nothing is held
-    const Tetromino* held() const { return m_held.get(); }
+    const Tetromino* held() const { return m_held ? &*m_held : nullptr; }
 
     // Next 3 upcoming pieces (lookahead into the bag)
     std::array<TetrominoType, 3> nextPieces() const;
 
+    // The next count pieces after the current one, any distance ahead; the
+    // first three match nextPieces()
+    void peekPieces(TetrominoType* out, int count) const;
+
+    // Pieces taken from the sequence since reset, including the current one
+    // and any pulled in by the first hold. Upcoming piece i (0-based) is
+    // pieceAt(seed(), dealt() + i).
+    uint64_t dealt() const;
+
+    // Versus garbage. Queued lines are cancelled by this game's own line
+    // clears first; a lock that clears nothing raises whatever is left as
+    // garbage rows sharing one hole column. Garbage is not part of the action
+    // stream, so replays of versus games do not re-simulate.
+    void receiveGarbage(int lines);
+    int  pendingGarbage() const { return m_garbageIn; }
+
+    // Lines this game has sent since the last call, after cancelling its queue
+    int  takeOutgoingGarbage();
+
+    // Captures / reinstates the simulation state. restore() expects a Game
+    // with the same seed and tick rate as the one that took the snapshot;
+    // restored stack cells are drawn in GARBAGE_COLOR.
+    GameSnapshot snapshot() const;
+    void         restore(const GameSnapshot& snap);
+
+    // Board::hash() extended with the current piece type, hold state and the
+    // buffered bag queue, so search can key positions that play out the same.
+    // Ignores the current piece's position, score and timers.
+    uint64_t hash() const;
+
 private:
-    Board                      m_board;
-    std::unique_ptr<Tetromino> m_current;
-    std::unique_ptr<Tetromino> m_held;
-    bool                       m_holdUsed = false;
+    Board                    m_board;
+    Tetromino                m_current{TetrominoType::I};
+    std::optional<Tetromino> m_held;
+    bool                     m_holdUsed = false;
 
-    // 7-bag randomizer
+    // 7-bag randomizer (bag.h): the generator has no state beyond the
+    // count of bags drawn
     std::array<TetrominoType, 14> m_bag; // two bags buffered for lookahead
     int                           m_bagIndex = 14;
-    std::mt19937                  m_rng;
+    uint32_t                      m_bagCount = 0;
+    uint32_t                      m_seed;
+
+    ReplayRecorder* m_recorder = nullptr;
+
+    int m_garbageIn  = 0;
+    int m_garbageOut = 0;
 
     ScoreState m_score;
+    int        m_pieces = 0;
     GameState  m_state = GameState::Playing;
 
-    float m_gravityAccum    = 0.f;
-    float m_gravityInterval = 1.f;
+    // Gravity in 1/GRAVITY_ONE rows per tick, accumulated each tick
+    static constexpr uint32_t GRAVITY_ONE = 1u << 16;
+
+    int      m_tickRate        = DEFAULT_TICK_RATE;
+    uint32_t m_gravityAccum    = 0;
+    uint32_t m_gravityPerTick  = 0;
+    uint32_t m_softDropPerTick = 0;
 
-    float m_lockTimer = 0.f;
-    float m_lockDelay = 0.5f;
-    bool  m_onGround  = false;
+    int  m_lockTicks      = 0;
+    int  m_lockDelayTicks = 0;
+    bool m_onGround       = false;
 
     int m_ghostRow = 0;
 
     void          refillBag();
     TetrominoType drawFromBag();
     void          spawnPiece(TetrominoType type);
-    void          tryMove(int dx, int dy);
+    bool          tryMove(int dx, int dy);
     void          tryRotate(int direction); // +1 CW, -1 CCW
+    template <TetrominoType T>
+    void          tryRotateAs(int direction);
     void          hardDrop();
     void          activateHold();
     void          lockCurrent();
     void          updateGhost();
     void          addScore(int linesCleared);
     float         gravityInterval(int level) const;
+    uint32_t      gravityPerTick(float interval) const;
     bool          isOnGround() const;
 };
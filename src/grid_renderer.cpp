@@ -0,0 +1,142 @@
+#include "grid_renderer.h"
+#include <algorithm>
+#include <cmath>
+
+static constexpr float MARGIN_CELLS = 1.f; // gap around each board, in cells
+
+GridRenderer::GridRenderer(sf::RenderWindow& window, int boards, std::optional<sf::FloatRect> area)
+    : m_window(window)
+{
+    const sf::Vector2u size = window.getSize();
+    layout(std::max(1, boards),
+           area.value_or(sf::FloatRect({0.f, 0.f}, {static_cast<float>(size.x), static_cast<float>(size.y)})));
+}
+
+// Picks the column count that gives the largest cells for the area
+void GridRenderer::layout(int boards, sf::FloatRect area) {
+    const float w = area.size.x;
+    const float h = area.size.y;
+
+    int columns = 1;
+    m_cellPx    = 0.f;
+    for (int c = 1; c <= boards; ++c) {
+        const int   rows = (boards + c - 1) / c;
+        const float cell = std::min(w / (c * (BOARD_COLS + MARGIN_CELLS)),
+                                    h / (rows * (BOARD_ROWS + MARGIN_CELLS)));
+        if (cell > m_cellPx) {
+            m_cellPx = cell;
+            columns  = c;
+        }
+    }
+    m_cellPx = std::max(1.f, std::floor(m_cellPx));
+
+    const float slotW  = (BOARD_COLS + MARGIN_CELLS) * m_cellPx;
+    const float slotH  = (BOARD_ROWS + MARGIN_CELLS) * m_cellPx;
+    const float boardW = BOARD_COLS * m_cellPx;
+    const float boardH = BOARD_ROWS * m_cellPx;
+    const float inset  = MARGIN_CELLS * m_cellPx / 2;
+
+    m_slots.assign(boards, Slot{});
+    m_frame.clear();
+    for (int i = 0; i < boards; ++i) {
+        Slot& slot  = m_slots[i];
+        slot.origin = {area.position.x + (i % columns) * slotW + inset,
+                       area.position.y + (i / columns) * slotH + inset};
+
+        const sf::Vector2f tl = slot.origin, tr{tl.x + boardW, tl.y};
+        const sf::Vector2f bl{tl.x, tl.y + boardH}, br{tl.x + boardW, tl.y + boardH};
+        const sf::Color    bg(15, 15, 25);
+        for (const sf::Vector2f& p : {tl, tr, bl, bl, tr, br})
+            m_frame.append({p, bg, {}});
+    }
+
+    // Every slot starts as degenerate triangles, i.e. nothing drawn
+    m_cells.resize(static_cast<size_t>(boards) * VERTS_PER_SLOT);
+}
+
+uint64_t GridRenderer::slotKey(const Board& board, const Tetromino& piece, GameState state) {
+    const Vec2i pos = piece.position();
+    return (static_cast<uint64_t>(board.version()) << 32)
+         | (static_cast<uint64_t>(state) << 24)
+         | (static_cast<uint64_t>(piece.type()) << 20)
+         | (static_cast<uint64_t>(piece.rotationState()) << 16)
+         | (static_cast<uint64_t>(pos.x + 8) << 8)
+         | static_cast<uint64_t>(pos.y + 8);
+}
+
+void GridRenderer::rebuildSlot(int index, const Board& board, const Tetromino& piece, GameState state) {
+    const bool over = state == GameState::GameOver;
+
+    // The falling piece is drawn unless the game ended with it overlapping
+    uint16_t pieceRows[BOARD_ROWS_TOTAL] = {};
+    if (!over) {
+        for (const Vec2i& c : piece.worldCells())
+            if (board.isInBounds(c.x, c.y))
+                pieceRows[c.y] |= static_cast<uint16_t>(1u << c.x);
+    }
+    const Color pieceColor = piece.color();
+
+    const Slot& slot = m_slots[index];
+    const float size = m_cellPx - 1.f;
+    sf::Vertex* v    = &m_cells[static_cast<size_t>(index) * VERTS_PER_SLOT];
+    for (int r = 2; r < BOARD_ROWS_TOTAL; ++r) {
+        const uint16_t stack = board.rowMask(r);
+        for (int c = 0; c < BOARD_COLS; ++c, v += VERTS_PER_CELL) {
+            const float x = slot.origin.x + c * m_cellPx;
+            const float y = slot.origin.y + (r - 2) * m_cellPx;
+
+            Color color;
+            if ((pieceRows[r] >> c) & 1u) {
+                color = pieceColor;
+            } else if ((stack >> c) & 1u) {
+                color = board.cellColor(c, r);
+            } else {
+                for (int k = 0; k < VERTS_PER_CELL; ++k) v[k].position = {x, y};
+                continue;
+            }
+
+            // Finished games stay on screen, dimmed
+            const int       shift = over ? 1 : 0;
+            const sf::Color fill(static_cast<uint8_t>(color.r >> shift),
+                                 static_cast<uint8_t>(color.g >> shift),
+                                 static_cast<uint8_t>(color.b >> shift));
+            const sf::Vector2f tl{x, y}, tr{x + size, y}, bl{x, y + size}, br{x + size, y + size};
+            const sf::Vector2f corners[VERTS_PER_CELL] = {tl, tr, bl, bl, tr, br};
+            for (int k = 0; k < VERTS_PER_CELL; ++k) {
+                v[k].position = corners[k];
+                v[k].color    = fill;
+            }
+        }
+    }
+}
+
+void GridRenderer::update(int index, const Board& board, const Tetromino& piece, GameState state) {
+    const uint64_t key = slotKey(board, piece, state);
+    if (m_slots[index].valid && m_slots[index].key == key) return;
+    rebuildSlot(index, board, piece, state);
+    m_slots[index].key   = key;
+    m_slots[index].valid = true;
+    ++m_rebuilt;
+}
+
+void GridRenderer::draw(const std::vector<Game>& games) {
+    m_rebuilt = 0;
+    const int count = std::min(boards(), static_cast<int>(games.size()));
+    for (int i = 0; i < count; ++i)
+        update(i, games[i].board(), games[i].current(), games[i].state());
+
+    m_window.draw(m_frame);
+    m_window.draw(m_cells);
+}
+
+void GridRenderer::draw(const std::vector<RenderState>& states, int skip) {
+    m_rebuilt = 0;
+    int slot = 0;
+    for (int i = 0; i < static_cast<int>(states.size()) && slot < boards(); ++i) {
+        if (i == skip) continue;
+        update(slot++, states[i].board, states[i].current, states[i].state);
+    }
+
+    m_window.draw(m_frame);
+    m_window.draw(m_cells);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <optional>
+#include <vector>
+#include "game.h"
+#include "render_state.h"
+
+// Spectator view of many games at once: boards are laid out in a grid scaled
+// to fill the window, and every board's cells live in one shared vertex array
+// drawn with a single call. Each board owns a fixed range of that array and
+// the range is only rewritten when the board or the falling piece changed.
+class GridRenderer {
+public:
+    // area: part of the window to lay the boards out in (default: all of it)
+    GridRenderer(sf::RenderWindow& window, int boards, std::optional<sf::FloatRect> area = {});
+
+    int boards() const { return static_cast<int>(m_slots.size()); }
+
+    // games.size() must equal boards()
+    void draw(const std::vector<Game>& games);
+
+    // Same for mirrored states, e.g. versus opponents: every state except
+    // states[skip] fills the next slot
+    void draw(const std::vector<RenderState>& states, int skip = -1);
+
+    // Boards whose geometry was rewritten by the last draw()
+    int rebuiltLastDraw() const { return m_rebuilt; }
+
+private:
+    struct Slot {
+        sf::Vector2f origin; // top-left of the visible play field
+        uint64_t     key   = 0;
+        bool         valid = false;
+    };
+
+    static constexpr int VISIBLE_CELLS  = BOARD_COLS * BOARD_ROWS;
+    static constexpr int VERTS_PER_CELL = 6;
+    static constexpr int VERTS_PER_SLOT = VISIBLE_CELLS * VERTS_PER_CELL;
+
+    sf::RenderWindow& m_window;
+    std::vector<Slot> m_slots;
+    float             m_cellPx = 1.f;
+    int               m_rebuilt = 0;
+
+    sf::VertexArray m_frame{sf::PrimitiveType::Triangles}; // backgrounds, built once
+    sf::VertexArray m_cells{sf::PrimitiveType::Triangles}; // VERTS_PER_SLOT per board
+
+    void            layout(int boards, sf::FloatRect area);
+    void            update(int index, const Board& board, const Tetromino& piece, GameState state);
+    void            rebuildSlot(int index, const Board& board, const Tetromino& piece, GameState state);
+    static uint64_t slotKey(const Board& board, const Tetromino& piece, GameState state);
+};
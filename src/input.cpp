@@ -1,6 +1,8 @@
 #include "input.h"
+#include <algorithm>
+#include <chrono>
 
-sf::Keyboard::Key InputHandler::bindingFor(Action a) {
+sf::Keyboard::Key InputHandler::defaultBinding(Action a) {
     switch (a) {
         case Action::MoveLeft:   return sf::Keyboard::Key::Left;
         case Action::MoveRight:  return sf::Keyboard::Key::Right;
@@ -15,79 +17,148 @@ sf::Keyboard::Key InputHandler::bindingFor(Action a) {
     }
 }
 
+// Soft drop is level-triggered (Game::step samples isHeld), so only the
+// sideways moves auto-repeat
 bool InputHandler::usesDAS(Action a) {
-    return a == Action::MoveLeft || a == Action::MoveRight || a == Action::SoftDrop;
+    return a == Action::MoveLeft || a == Action::MoveRight;
 }
 
 InputHandler::InputHandler() {
     m_states.fill(KeyState{});
+    m_keyToAction.fill(-1);
+    for (int i = 0; i < ACTION_COUNT; ++i)
+        setBinding(static_cast<Action>(i), defaultBinding(static_cast<Action>(i)));
+    setSettings(InputSettings{DAS_DELAY, DAS_INTERVAL});
+}
+
+int64_t InputHandler::nowUs() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void InputHandler::setSettings(const InputSettings& settings) {
+    m_settings = settings;
+    m_dasUs    = std::max<int64_t>(0, static_cast<int64_t>(settings.dasDelay * 1e6f));
+    m_arrUs    = std::max<int64_t>(0, static_cast<int64_t>(settings.arr * 1e6f));
+}
+
+void InputHandler::setBinding(Action a, sf::Keyboard::Key key) {
+    const int action = static_cast<int>(a);
+    const int oldKey = static_cast<int>(m_bindings[action]) + 1;
+    if (oldKey >= 0 && oldKey < KEY_TABLE_SIZE && m_keyToAction[oldKey] == action)
+        m_keyToAction[oldKey] = -1;
+
+    m_bindings[action] = key;
+    const int newKey = static_cast<int>(key) + 1;
+    if (key != sf::Keyboard::Key::Unknown && newKey >= 0 && newKey < KEY_TABLE_SIZE)
+        m_keyToAction[newKey] = static_cast<int8_t>(action);
 }
 
 void InputHandler::handleEvent(const sf::Event& event) {
     // SFML 3 event handling via std::visit / getIf
-    if (const auto* kp = event.getIf<sf::Event::KeyPressed>()) {
-        for (int i = 0; i < ACTION_COUNT; ++i) {
-            Action a = static_cast<Action>(i);
-            if (kp->code == bindingFor(a) && !m_states[i].held) {
-                m_states[i].held        = true;
-                m_states[i].justPressed = true;
-                m_states[i].firedThisFrame = true;
-                m_states[i].holdTimer   = 0.f;
-                m_states[i].dasActive   = false;
-                m_states[i].dasTimer    = 0.f;
-            }
-        }
-    } else if (const auto* kr = event.getIf<sf::Event::KeyReleased>()) {
-        for (int i = 0; i < ACTION_COUNT; ++i) {
-            Action a = static_cast<Action>(i);
-            if (kr->code == bindingFor(a)) {
-                m_states[i].held        = false;
-                m_states[i].dasActive   = false;
-                m_states[i].holdTimer   = 0.f;
-                m_states[i].dasTimer    = 0.f;
-            }
-        }
+    if (const auto* kp = event.getIf<sf::Event::KeyPressed>())
+        handleKey(kp->code, true, nowUs());
+    else if (const auto* kr = event.getIf<sf::Event::KeyReleased>())
+        handleKey(kr->code, false, nowUs());
+}
+
+void InputHandler::handleKey(sf::Keyboard::Key key, bool pressed, int64_t timeUs) {
+    const int index = static_cast<int>(key) + 1;
+    if (index < 0 || index >= KEY_TABLE_SIZE || m_keyToAction[index] < 0) return;
+
+    const int action = m_keyToAction[index];
+    auto&     s      = m_states[action];
+
+    if (pressed) {
+        if (s.held) return; // OS key repeat
+        s.held        = true;
+        s.justPressed = true;
+        s.pressUs     = timeUs;
+        s.countedUs   = timeUs;
+    } else if (s.held) {
+        // Keep the repeats that were due before the key came up
+        bool instant = false;
+        if (usesDAS(static_cast<Action>(action)))
+            countRepeats(s, timeUs, instant);
+        if (instant) s.pendingRepeats = MAX_MOVE_REPEATS;
+        s.held = false;
+    }
+}
+
+int64_t InputHandler::repeatsBy(int64_t pressUs, int64_t t) const {
+    const int64_t sinceDas = t - pressUs - m_dasUs;
+    if (sinceDas < 0 || m_arrUs == 0) return 0;
+    return sinceDas / m_arrUs;
+}
+
+// Adds repeats scheduled in (countedUs, t]; with ARR 0, flags an instant slide
+// once DAS has elapsed instead
+void InputHandler::countRepeats(KeyState& s, int64_t t, bool& instant) {
+    if (t <= s.countedUs) return;
+    if (m_arrUs == 0) {
+        instant = t - s.pressUs >= m_dasUs;
+    } else {
+        s.pendingRepeats += static_cast<int>(repeatsBy(s.pressUs, t) - repeatsBy(s.pressUs, s.countedUs));
     }
+    s.countedUs = t;
 }
 
-void InputHandler::update(float dt) {
+void InputHandler::update(int64_t now) {
     for (int i = 0; i < ACTION_COUNT; ++i) {
         auto& s = m_states[i];
 
-        // Carry justPressed (set by handleEvent) into firedThisFrame,
-        // then clear justPressed so it doesn't persist past this frame.
-        s.firedThisFrame = s.justPressed;
-        s.justPressed    = false;
-
-        if (s.held && usesDAS(static_cast<Action>(i))) {
-            s.holdTimer += dt;
-            if (s.holdTimer >= DAS_DELAY) {
-                s.dasActive = true;
-                s.dasTimer += dt;
-                if (s.dasTimer >= DAS_INTERVAL) {
-                    s.firedThisFrame = true;
-                    s.dasTimer = 0.f;
-                }
-            }
-        } else if (!s.held) {
-            s.holdTimer = 0.f;
-            s.dasActive = false;
-            s.dasTimer  = 0.f;
-        }
+        // Carry justPressed (set by handleKey) into this tick, then clear it
+        // so it doesn't persist past this tick
+        s.pressedThisTick = s.justPressed;
+        s.justPressed     = false;
+
+        bool instant = false;
+        if (s.held && usesDAS(static_cast<Action>(i)))
+            countRepeats(s, now, instant);
+
+        s.repeats        = (s.pressedThisTick ? 1 : 0) + s.pendingRepeats;
+        s.pendingRepeats = 0;
+        if (instant) s.repeats = MAX_MOVE_REPEATS; // slide to the wall
     }
 }
 
 bool InputHandler::isJustPressed(Action a) const {
-    // firedThisFrame is true on first press; for DAS actions it's also true
-    // on repeats, but isJustPressed is only called for non-DAS actions.
-    const auto& s = m_states[static_cast<int>(a)];
-    return s.firedThisFrame && !s.dasActive;
+    return m_states[static_cast<int>(a)].pressedThisTick;
 }
 
 bool InputHandler::isActive(Action a) const {
-    return m_states[static_cast<int>(a)].firedThisFrame;
+    return m_states[static_cast<int>(a)].repeats > 0;
 }
 
 bool InputHandler::isHeld(Action a) const {
     return m_states[static_cast<int>(a)].held;
 }
+
+int InputHandler::repeatCount(Action a) const {
+    return m_states[static_cast<int>(a)].repeats;
+}
+
+uint16_t InputHandler::actionMask(int maxShift) const {
+    uint16_t mask = 0;
+    for (int i = 0; i < ACTION_COUNT; ++i) {
+        const Action a = static_cast<Action>(i);
+        // A SoftDrop tap released before the tick still drops one step
+        const bool fire = (a == Action::SoftDrop) ? isHeld(a) || isJustPressed(a) : isActive(a);
+        if (fire && !usesDAS(a)) mask |= actionBit(a);
+    }
+
+    // The mask has one repeat count for both directions, so when both fire
+    // the more recently pressed one moves, with its own count
+    const KeyState& left  = m_states[static_cast<int>(Action::MoveLeft)];
+    const KeyState& right = m_states[static_cast<int>(Action::MoveRight)];
+    const KeyState* move  = nullptr;
+    Action          dir   = Action::MoveLeft;
+    if (left.repeats > 0 && (right.repeats == 0 || left.pressUs > right.pressUs)) {
+        move = &left;
+    } else if (right.repeats > 0) {
+        move = &right;
+        dir  = Action::MoveRight;
+    }
+    if (!move) return mask;
+    return withMoveRepeats(mask | actionBit(dir), std::min(move->repeats, maxShift));
+}
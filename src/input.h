@@ -1,56 +1,86 @@
 #pragma once
 #include <SFML/Window.hpp>
 #include <array>
+#include <cstdint>
+#include "action.h"
 
-enum class Action {
-    MoveLeft,
-    MoveRight,
-    SoftDrop,
-    HardDrop,
-    RotateCW,
-    RotateCCW,
-    Hold,
-    Pause,
-    Quit,
-    Count
+// Delayed Auto Shift timing; adjustable at runtime via InputHandler::setSettings
+struct InputSettings {
+    float dasDelay = 0.150f; // seconds held before a move starts repeating
+    float arr      = 0.050f; // seconds between repeats; 0 = instant slide to the wall
 };
 
-constexpr int ACTION_COUNT = static_cast<int>(Action::Count);
-
 class InputHandler {
 public:
-    // Delayed Auto Shift constants
+    // Default DAS constants
     static constexpr float DAS_DELAY    = 0.150f; // seconds before repeating
     static constexpr float DAS_INTERVAL = 0.050f; // repeat rate once triggered
 
     InputHandler();
 
-    // Call for each SFML event inside the poll loop
+    // Monotonic clock used for key timestamps, in microseconds
+    static int64_t nowUs();
+
+    void                 setSettings(const InputSettings& settings);
+    const InputSettings& settings() const { return m_settings; }
+
+    // Rebinds an action; the previous key for it stops mapping to anything
+    void              setBinding(Action a, sf::Keyboard::Key key);
+    sf::Keyboard::Key binding(Action a) const { return m_bindings[static_cast<int>(a)]; }
+
+    // Call for each SFML event inside the poll loop (timestamped on arrival)
     void handleEvent(const sf::Event& event);
 
-    // Call once per frame — advances DAS timers using dt
-    void update(float dt);
+    // Key press/release stamped with the time it was received (nowUs clock),
+    // e.g. forwarded from the window thread
+    void handleKey(sf::Keyboard::Key key, bool pressed, int64_t timeUs);
+
+    // Call once per simulation tick with the current time. Counts every DAS
+    // repeat scheduled since the previous call, so several can fire per tick.
+    void update(int64_t nowUs);
 
-    // True only on the first frame the key was pressed
+    // True only on the first tick after the key was pressed
     bool isJustPressed(Action a) const;
 
-    // True if action should fire this frame (DAS-aware for movement)
+    // True if action should fire this tick (DAS-aware for movement)
     bool isActive(Action a) const;
 
     bool isHeld(Action a) const;
 
+    // How many times a movement fires this tick (0 if inactive)
+    int repeatCount(Action a) const;
+
+    // Packs this tick's state into the bitmask consumed by Game::step:
+    // SoftDrop reports held state (or a press this tick), every other
+    // action reports isActive. One direction's repeats, capped at maxShift
+    // (the board width), go into the withMoveRepeats field.
+    uint16_t actionMask(int maxShift) const;
+
 private:
     struct KeyState {
-        bool  held           = false;
-        bool  justPressed    = false;
-        bool  firedThisFrame = false;
-        float holdTimer      = 0.f;
-        bool  dasActive      = false;
-        float dasTimer       = 0.f;
+        bool    held            = false;
+        bool    justPressed     = false; // pressed since the last update()
+        bool    pressedThisTick = false;
+        int     repeats         = 0;     // times the action fires this tick
+        int     pendingRepeats  = 0;     // DAS repeats counted before a release
+        int64_t pressUs         = 0;
+        int64_t countedUs       = 0;     // DAS repeats counted up to this time
     };
 
-    static sf::Keyboard::Key bindingFor(Action a);
+    // Repeats scheduled in (press, t] for a key pressed at pressUs
+    int64_t repeatsBy(int64_t pressUs, int64_t t) const;
+    void    countRepeats(KeyState& s, int64_t t, bool& instant);
+
+    static sf::Keyboard::Key defaultBinding(Action a);
     static bool              usesDAS(Action a);
 
-    std::array<KeyState, ACTION_COUNT> m_states{};
+    static constexpr int KEY_TABLE_SIZE = sf::Keyboard::KeyCount + 1; // +1 for Unknown
+
+    InputSettings m_settings;
+    int64_t       m_dasUs = 0;
+    int64_t       m_arrUs = 0;
+
+    std::array<sf::Keyboard::Key, ACTION_COUNT> m_bindings{};
+    std::array<int8_t, KEY_TABLE_SIZE>          m_keyToAction{}; // -1 = unbound
+    std::array<KeyState, ACTION_COUNT>          m_states{};
 };
@@ -1,9 +1,247 @@
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <string>
+#include "cli_args.h"
+#include "frame_stats.h"
 #include "game.h"
+#include "grid_renderer.h"
+#include "policy.h"
 #include "renderer.h"
-#include "input.h"
+#include "replay.h"
+#include "sim_thread.h"
+#include "thread_pool.h"
+#if TETRIS_VERSUS
+#include <chrono>
+#include <thread>
+#include "net_socket.h"
+#include "versus_protocol.h"
+#endif
+
+// Spectator mode (--grid): N bot games stepped in parallel, drawn as a grid
+static int runGrid(int count, int tickRate) {
+    sf::RenderWindow window(sf::VideoMode({1280, 720}), "Tetris grid");
+    window.setFramerateLimit(60);
+
+    std::vector<Game>   games;
+    std::vector<Policy> policies;
+    games.reserve(count);
+    uint32_t nextSeed = 1;
+    for (int i = 0; i < count; ++i) {
+        games.emplace_back(nextSeed++, tickRate);
+        policies.emplace_back(BeamSearchPolicy());
+    }
+
+    GridRenderer     grid(window, count);
+    WorkStealingPool pool;
+
+    // Bots are stepped in parallel on the pool; the window thread only draws
+    // once every game has finished the tick
+    const float tickSeconds = 1.f / tickRate;
+    float       accum       = 0.f;
+    int         finished    = 0;
+    int         bestScore   = 0;
+    sf::Clock   frameClock, titleClock;
+
+    while (window.isOpen()) {
+        while (const auto event = window.pollEvent()) {
+            if (event->is<sf::Event::Closed>())
+                window.close();
+            else if (const auto* kp = event->getIf<sf::Event::KeyPressed>())
+                if (kp->code == sf::Keyboard::Key::Escape) window.close();
+        }
+
+        // Cap catch-up so a slow frame doesn't snowball
+        accum = std::min(accum + frameClock.restart().asSeconds(), 8 * tickSeconds);
+        for (; accum >= tickSeconds; accum -= tickSeconds) {
+            pool.run(count, 1, [&](int, int i) {
+                if (games[i].state() == GameState::Playing)
+                    games[i].step(policies[i](games[i]));
+            });
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (games[i].state() != GameState::GameOver) continue;
+            ++finished;
+            bestScore   = std::max(bestScore, games[i].score().score);
+            games[i]    = Game(nextSeed++, tickRate);
+            policies[i] = BeamSearchPolicy();
+        }
+
+        if (titleClock.getElapsedTime().asSeconds() >= 1.f) {
+            titleClock.restart();
+            window.setTitle("Tetris grid - " + std::to_string(count) + " games, " +
+                            std::to_string(finished) + " finished, best " +
+                            std::to_string(bestScore));
+        }
+
+        window.clear(sf::Color(10, 10, 18));
+        grid.draw(games);
+        window.display();
+    }
+    return 0;
+}
+
+#if TETRIS_VERSUS
+// Versus client (--connect): the server owns every Game; this window only
+// samples the keyboard, sends one Input per frame and draws the mirrored
+// states. Players see their own board full size with opponents beside it;
+// spectators get every board in a grid.
+static int runVersus(const std::string& address, const InputSettings& settings) {
+    const int fd = net::connectTo(address);
+    if (fd < 0) {
+        std::fprintf(stderr, "tetris: cannot connect to '%s'\n", address.c_str());
+        return 1;
+    }
+    net::Connection conn(fd);
+    conn.send(versus::MsgType::Hello, {versus::PROTOCOL_VERSION});
+
+    // The Welcome tells us which board is ours
+    versus::Welcome      welcome;
+    versus::MsgType      type;
+    std::vector<uint8_t> payload;
+    bool                 welcomed = false;
+    for (int waited = 0; !welcomed && waited < 5000; ++waited) {
+        if (!conn.flush() || !conn.receive()) break;
+        if (conn.next(type, payload))
+            welcomed = type == versus::MsgType::Welcome && versus::decodeWelcome(payload, welcome);
+        else
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (!welcomed) {
+        std::fprintf(stderr, "tetris: no welcome from '%s'\n", address.c_str());
+        return 1;
+    }
+
+    const bool spectator = welcome.player == versus::SPECTATOR;
+    const int  opponents = spectator ? welcome.players : welcome.players - 1;
+
+    // Own board as in single player (640 wide), opponents in a column beside it
+    constexpr int BOARD_ORIGIN_X = 160;
+    constexpr int BOARD_ORIGIN_Y = 40;
+    const unsigned sideW = spectator ? 1280u : (opponents > 0 ? 400u : 0u);
+    const unsigned winW  = spectator ? sideW : 640u + sideW;
+    sf::RenderWindow window(sf::VideoMode({winW, 720}), "Tetris versus",
+                            sf::Style::Close | sf::Style::Titlebar);
+    window.setFramerateLimit(60);
+    window.setKeyRepeatEnabled(false);
+
+    Renderer renderer(window, BOARD_ORIGIN_X, BOARD_ORIGIN_Y);
+    if (!renderer.loadFont("/System/Library/Fonts/Helvetica.ttc"))
+        renderer.loadFont("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf");
+
+    std::optional<GridRenderer> grid;
+    if (opponents > 0)
+        grid.emplace(window, opponents,
+                     sf::FloatRect({static_cast<float>(winW - sideW), 0.f},
+                                   {static_cast<float>(sideW), 720.f}));
+
+    InputHandler input;
+    input.setSettings(settings);
+
+    std::vector<RenderState> states(welcome.players);
+    uint32_t                 tick     = 0;
+    uint16_t                 lastSent = 0;
+    bool                     synced   = false;
+    const int                me       = spectator ? -1 : welcome.player;
+
+    while (window.isOpen()) {
+        while (const auto event = window.pollEvent()) {
+            if (event->is<sf::Event::Closed>()) window.close();
+            else input.handleEvent(*event);
+        }
+        input.update(InputHandler::nowUs());
+        if (input.isJustPressed(Action::Quit)) window.close();
+
+        // Idle frames are only sent to report a released SoftDrop
+        const uint16_t actions = input.actionMask(BOARD_COLS);
+        if (!spectator && (actions != 0 || lastSent != 0)) {
+            conn.send(versus::MsgType::Input, versus::encodeInput(actions));
+            lastSent = actions;
+        }
+
+        const bool connected = conn.flush() && conn.receive();
+        while (conn.next(type, payload)) {
+            if (type == versus::MsgType::Snapshot || (synced && type == versus::MsgType::Delta))
+                synced = versus::applyState(payload, states, tick);
+        }
+        if (!connected) window.setTitle("Tetris versus - disconnected");
+
+        window.clear(sf::Color(10, 10, 18));
+        if (!spectator) renderer.drawAll(states[me]);
+        if (grid) grid->draw(states, me);
+        window.display();
+    }
+    return 0;
+}
+#endif
+
+// Usage: tetris [--record FILE | --replay FILE] [--frame-stats FILE] [--tick-rate HZ]
+//               [--das MS] [--arr MS]
+//        tetris --grid N [--tick-rate HZ]
+//        tetris --connect ADDR [--das MS] [--arr MS]
+//   --record       saves the session as a replay when the window closes
+//   --replay       plays a recorded replay back in real time (Esc quits)
+//   --frame-stats  writes per-phase frame timing histograms as CSV on exit
+//   --tick-rate    simulation ticks per second, 1-65535 (default 240)
+//   --das          delay before a held move starts repeating, 0-10000 (default 150)
+//   --arr          delay between repeats, 0 = slide to the wall (default 50)
+//   --grid         spectator mode: N (1-1024) bot games (BeamSearchPolicy) in one window;
+//                  finished games restart with the next seed
+//   --connect      join a tetris_versus_server at "host:port" or a Unix socket
+//                  path, as a player or, once the match is full, a spectator
+// F3 toggles the frame timing overlay.
+int main(int argc, char** argv) {
+    constexpr int MAX_TICK_RATE  = 0xFFFF; // what the versus Welcome can carry
+    constexpr int MAX_REPEAT_MS  = 10000;
+    constexpr int MAX_GRID_GAMES = 1024;
+
+    std::string   recordPath, replayPath, statsPath, connectAddress;
+    int           tickRate = 240;
+    int           gridGames = 0;
+    InputSettings inputSettings;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg   = argv[i];
+        const char* value = argv[i + 1];
+        int         ms    = 0;
+        bool        ok    = true;
+        if (arg == "--record")           recordPath = value;
+        else if (arg == "--replay")      replayPath = value;
+        else if (arg == "--frame-stats") statsPath  = value;
+        else if (arg == "--tick-rate")   ok = parseInt(value, 1, MAX_TICK_RATE, tickRate);
+        else if (arg == "--das")         ok = parseInt(value, 0, MAX_REPEAT_MS, ms);
+        else if (arg == "--arr")         ok = parseInt(value, 0, MAX_REPEAT_MS, ms);
+        else if (arg == "--grid")        ok = parseInt(value, 1, MAX_GRID_GAMES, gridGames);
+        else if (arg == "--connect")     connectAddress = value;
+        if (!ok) {
+            std::fprintf(stderr, "tetris: bad %s '%s'\n", arg.c_str(), value);
+            return 1;
+        }
+        if (arg == "--das") inputSettings.dasDelay = ms / 1000.f;
+        if (arg == "--arr") inputSettings.arr      = ms / 1000.f;
+    }
+
+    if (!connectAddress.empty()) {
+#if TETRIS_VERSUS
+        return runVersus(connectAddress, inputSettings);
+#else
+        std::fprintf(stderr, "tetris: versus mode is not available on this platform\n");
+        return 1;
+#endif
+    }
+
+    if (gridGames > 0)
+        return runGrid(gridGames, tickRate);
+
+    Replay replay;
+    if (!replayPath.empty() && !replay.load(replayPath)) {
+        std::fprintf(stderr, "tetris: cannot read replay '%s'\n", replayPath.c_str());
+        return 1;
+    }
 
-int main() {
     // Window: 160 (hold) + 320 (board) + 160 (next/score) = 640 wide
     //         40 (top margin) + 640 (board) + 40 (bottom) = 720 tall
     constexpr unsigned WIN_W = 640;
@@ -14,10 +252,21 @@ int main() {
     sf::RenderWindow window(sf::VideoMode({WIN_W, WIN_H}), "Tetris",
                             sf::Style::Close | sf::Style::Titlebar);
     window.setFramerateLimit(60);
+    // The simulation thread does its own key repeat (DAS)
+    window.setKeyRepeatEnabled(false);
 
-    Game         game;
-    InputHandler input;
-    Renderer     renderer(window, BOARD_ORIGIN_X, BOARD_ORIGIN_Y);
+    Game     game = replayPath.empty() ? Game(std::random_device{}(), tickRate)
+                                       : Game(replay.seed, replay.tickRate);
+    Renderer renderer(window, BOARD_ORIGIN_X, BOARD_ORIGIN_Y);
+
+    std::optional<ReplayRecorder> recorder;
+    std::optional<ReplayReader>   reader;
+    if (!recordPath.empty()) {
+        recorder.emplace(game);
+        game.setRecorder(&*recorder);
+    }
+    if (!replayPath.empty())
+        reader.emplace(replay);
 
     // Try to load a system font. Fall back gracefully if not found.
     if (!renderer.loadFont("/System/Library/Fonts/Helvetica.ttc")) {
@@ -25,33 +274,66 @@ int main() {
         renderer.loadFont("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf");
     }
 
-    sf::Clock clock;
+    // Game is owned by the simulation thread from here until sim.stop()
+    SimulationThread sim(game, reader ? &*reader : nullptr);
+    sim.input().setSettings(inputSettings);
+    sim.start();
+
+    FrameStats  stats;
+    bool        showStats = false;
+    std::string statsText;
+    sf::Clock   statsRefresh;
 
     while (window.isOpen()) {
-        // Reset per-frame justPressed state before processing events
-        // (input.update() is called after events so DAS timers use real dt)
-        float dt = clock.restart().asSeconds();
-        dt = std::min(dt, 0.05f); // clamp to avoid spiral-of-death
+        stats.beginFrame();
 
         while (const auto event = window.pollEvent()) {
             if (event->is<sf::Event::Closed>()) {
                 window.close();
                 break;
             }
-            input.handleEvent(*event);
+            if (const auto* kp = event->getIf<sf::Event::KeyPressed>()) {
+                if (kp->code == sf::Keyboard::Key::F3) showStats = !showStats;
+                if (const uint64_t key = sim.pushKey(kp->code, true)) stats.notePress(key);
+            } else if (const auto* kr = event->getIf<sf::Event::KeyReleased>()) {
+                sim.pushKey(kr->code, false);
+            }
         }
+        stats.endPhase(FramePhase::Events);
 
-        input.update(dt);
-
-        if (!game.update(input, dt)) {
+        if (sim.quitRequested()) {
             window.close();
             break;
         }
 
+        // The simulation times its own ticks; collect them with the state
+        const SimFrame& frame = sim.latest();
+        stats.addTicks(frame.ticks);
+
         window.clear(sf::Color(10, 10, 18));
-        renderer.drawAll(game);
+        renderer.drawAll(frame.state);
+        if (showStats) {
+            // Refresh the numbers a few times a second so they stay readable
+            if (statsText.empty() || statsRefresh.getElapsedTime().asSeconds() >= 0.25f) {
+                statsText = stats.summary();
+                statsRefresh.restart();
+            }
+            renderer.drawStatsOverlay(statsText);
+        }
+        stats.endPhase(FramePhase::Draw);
+
         window.display();
+        stats.endPhase(FramePhase::Display);
+        stats.endFrame(frame.keysApplied);
     }
 
+    sim.stop();
+
+    if (!statsPath.empty() && !stats.writeCsv(statsPath))
+        std::fprintf(stderr, "tetris: cannot write frame stats '%s'\n", statsPath.c_str());
+
+    if (recorder && !recorder->finish(game).save(recordPath))
+        std::fprintf(stderr, "tetris: cannot write replay '%s'\n", recordPath.c_str());
+
     return 0;
 }
@@ -0,0 +1,119 @@
+#include "movegen.h"
+#include <algorithm>
+
+// Placement indices travel as BeamSearchPolicy's int16_t rootMove
+static_assert(MoveGenerator::MAX_PLACEMENTS <= INT16_MAX, "placement index must fit int16_t");
+
+int MoveGenerator::encode(Vec2i pos, int rotation) {
+    return (((pos.y - Y_MIN) * X_SPAN) + (pos.x - X_MIN)) * 4 + rotation;
+}
+
+Vec2i MoveGenerator::decodePos(int node) {
+    int cell = node >> 2;
+    return {cell % X_SPAN + X_MIN, cell / X_SPAN + Y_MIN};
+}
+
+// Cells covered by an in-bounds piece state, packed as top row + up to 4 row masks
+static uint64_t footprint(TetrominoType type, Vec2i pos, int rotation) {
+    const ColumnMask& mask = *columnMask(type, rotation, pos.x);
+    uint64_t key = static_cast<uint64_t>(pos.y + mask.top) << 40;
+    for (int i = 0; i < 4; ++i)
+        key |= static_cast<uint64_t>(mask.rows[i]) << (10 * i);
+    return key;
+}
+
+int MoveGenerator::generate(const Board& board, TetrominoType type) {
+    Tetromino start(type);
+    start.setPosition(SPAWN_POSITION);
+    return generate(board, start);
+}
+
+int MoveGenerator::generate(const Board& board, const Tetromino& start) {
+    m_visited.fill(0);
+    m_count = 0;
+    return withPieceType(start.type(), [&](auto type) {
+        return search<decltype(type)::value>(board, start);
+    });
+}
+
+template <TetrominoType T>
+int MoveGenerator::search(const Board& board, const Tetromino& start) {
+    if (!board.fits<T>(start.position(), start.rotationState()))
+        return 0;
+
+    int head = 0, tail = 0;
+    const int root = encode(start.position(), start.rotationState());
+    m_visited[root] = 1;
+    m_parent[root]  = static_cast<uint16_t>(root);
+    m_queue[tail++] = static_cast<uint16_t>(root);
+
+    auto visit = [&](int from, Vec2i pos, int rot, Move via) {
+        int node = encode(pos, rot);
+        if (m_visited[node]) return;
+        m_visited[node] = 1;
+        m_parent[node]  = static_cast<uint16_t>(from);
+        m_via[node]     = via;
+        m_queue[tail++] = static_cast<uint16_t>(node);
+    };
+
+    while (head < tail) {
+        const int   node = m_queue[head++];
+        const Vec2i pos  = decodePos(node);
+        const int   rot  = decodeRot(node);
+
+        const Vec2i left  = pos + Vec2i{-1, 0};
+        const Vec2i right = pos + Vec2i{ 1, 0};
+        const Vec2i below = pos + Vec2i{ 0, 1};
+        if (board.fits<T>(left, rot))  visit(node, left,  rot, Move::Left);
+        if (board.fits<T>(right, rot)) visit(node, right, rot, Move::Right);
+
+        if constexpr (T != TetrominoType::O) {
+            for (int direction : {1, -1}) {
+                const int kick = board.firstFreeKick<T>(pos, rot, direction);
+                if (kick < 0) continue;
+                const auto& offset = PIECE_KICKS<T>[direction > 0]->offsets[rot][kick];
+                visit(node, pos + Vec2i{offset[0], offset[1]}, (rot + direction) & 3,
+                      direction > 0 ? Move::RotateCW : Move::RotateCCW);
+            }
+        }
+
+        if (board.fits<T>(below, rot)) {
+            visit(node, below, rot, Move::SoftDrop);
+            continue;
+        }
+
+        // Resting state: record it unless another state already covers the same cells
+        const uint64_t key = footprint(T, pos, rot);
+        const auto     end = m_footprints.begin() + m_count;
+        if (std::find(m_footprints.begin(), end, key) != end) continue;
+        m_footprints[m_count] = key;
+        m_nodes[m_count]      = static_cast<uint16_t>(node);
+        m_placements[m_count] = {pos, rot};
+        ++m_count;
+    }
+
+    return m_count;
+}
+
+int MoveGenerator::pathTo(int i, std::array<Move, MAX_PATH>& out) const {
+    // Walk parents back to the root, then reverse into forward order
+    std::array<Move, STATES> reversed;
+    int len  = 0;
+    int node = m_nodes[i];
+    while (m_parent[node] != node) {
+        reversed[len++] = m_via[node];
+        node = m_parent[node];
+    }
+
+    // Trailing soft drops fall straight onto the resting row, so a hard drop
+    // from the last sideways/rotation state lands in the same place
+    int last = 0;
+    while (last < len && reversed[last] == Move::SoftDrop) ++last;
+    if (len - last + 1 > MAX_PATH) return 0;
+
+    int n = 0;
+    for (int k = len - 1; k >= last; --k)
+        out[n++] = reversed[k];
+    out[n++] = Move::HardDrop;
+    return n;
+}
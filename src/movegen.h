@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "board.h"
+#include "tetromino.h"
+
+// Single inputs the generator explores. SoftDrop moves the piece down exactly
+// one row; HardDrop only ever appears as the last step of a path.
+enum class Move : uint8_t {
+    Left,
+    Right,
+    SoftDrop,
+    RotateCW,
+    RotateCCW,
+    HardDrop,
+};
+
+struct Placement {
+    Vec2i position;
+    int   rotation;
+};
+
+// Breadth-first search over (column, row, rotation) from the spawn state,
+// using the same moves and SRS kicks as Game. Every distinct resting
+// footprint is reported once, even when several rotation states produce the
+// same cells (I, S, Z). All storage is fixed-size and reused between calls.
+class MoveGenerator {
+public:
+    // Placements are distinct cell sets that fit on the board: one of at
+    // most 4 shapes with its bounding box's top-left cell on the board, so
+    // this bound is never exceeded and generate() drops nothing
+    static constexpr int MAX_PLACEMENTS = 4 * BOARD_COLS * BOARD_ROWS_TOTAL;
+    static constexpr int MAX_PATH       = 64;
+
+    // Enumerates placements for a fresh piece at SPAWN_POSITION; returns count
+    int generate(const Board& board, TetrominoType type);
+
+    // Enumerates placements starting from an arbitrary piece state
+    int generate(const Board& board, const Tetromino& start);
+
+    int              count()          const { return m_count; }
+    const Placement& placement(int i) const { return m_placements[i]; }
+
+    // Shortest input sequence from the start state to placement i of the last
+    // generate() call, ending in HardDrop. Returns the number of moves written,
+    // or 0 if the path does not fit in MAX_PATH.
+    int pathTo(int i, std::array<Move, MAX_PATH>& out) const;
+
+private:
+    // Pivot column/row ranges wide enough for every in-bounds piece state
+    static constexpr int X_MIN  = -2;
+    static constexpr int Y_MIN  = -2;
+    static constexpr int X_SPAN = BOARD_COLS + 4;
+    static constexpr int Y_SPAN = BOARD_ROWS_TOTAL + 4;
+    static constexpr int STATES = X_SPAN * Y_SPAN * 4;
+
+    static int   encode(Vec2i pos, int rotation);
+    static Vec2i decodePos(int node);
+    static int   decodeRot(int node) { return node & 3; }
+
+    // The BFS behind generate(), specialized per piece type
+    template <TetrominoType T>
+    int search(const Board& board, const Tetromino& start);
+
+    std::array<uint8_t,  STATES> m_visited{};
+    std::array<uint16_t, STATES> m_parent{};
+    std::array<Move,     STATES> m_via{};
+    std::array<uint16_t, STATES> m_queue{};
+
+    std::array<Placement, MAX_PLACEMENTS> m_placements{};
+    std::array<uint16_t,  MAX_PLACEMENTS> m_nodes{};
+    std::array<uint64_t,  MAX_PLACEMENTS> m_footprints{};
+    int                                   m_count = 0;
+};
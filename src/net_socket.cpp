@@ -0,0 +1,236 @@
+#include "net_socket.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#if defined(MSG_NOSIGNAL)
+static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static constexpr int SEND_FLAGS = 0; // SO_NOSIGPIPE is set per socket instead
+#endif
+
+namespace net {
+
+// ---------------------------------------------------------------------------
+// Socket setup
+// ---------------------------------------------------------------------------
+
+static bool isUnixPath(const std::string& address) {
+    return address.find('/') != std::string::npos;
+}
+
+static void configure(int fd, bool tcp) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+#if defined(SO_NOSIGPIPE)
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof one);
+#endif
+    if (tcp) {
+        // Deltas are small and latency-bound; don't let Nagle hold them back
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof on);
+    }
+}
+
+static bool unixAddress(const std::string& path, sockaddr_un& addr) {
+    if (path.size() >= sizeof addr.sun_path) return false;
+    std::memset(&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+static addrinfo* resolve(const std::string& address, bool passive) {
+    const size_t colon = address.rfind(':');
+    const std::string host = colon == std::string::npos ? address : address.substr(0, colon);
+    const std::string port = colon == std::string::npos ? std::to_string(versus::DEFAULT_PORT)
+                                                        : address.substr(colon + 1);
+    addrinfo hints{};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags    = passive ? AI_PASSIVE : 0;
+
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result) != 0)
+        return nullptr;
+    return result;
+}
+
+int listenOn(const std::string& address) {
+    if (isUnixPath(address)) {
+        sockaddr_un addr;
+        if (!unixAddress(address, addr)) return -1;
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        unlink(address.c_str()); // stale socket from a previous run
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) != 0 || listen(fd, 16) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        configure(fd, false);
+        return fd;
+    }
+
+    addrinfo* list = resolve(address, true);
+    int       fd   = -1;
+    for (addrinfo* ai = list; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof reuse);
+        if (bind(fd, ai->ai_addr, ai->ai_addrlen) != 0 || listen(fd, 16) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    if (list) freeaddrinfo(list);
+    if (fd >= 0) configure(fd, false);
+    return fd;
+}
+
+int acceptOn(int listenFd) {
+    const int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) return -1;
+
+    sockaddr_storage local{};
+    socklen_t        length = sizeof local;
+    getsockname(fd, reinterpret_cast<sockaddr*>(&local), &length);
+    configure(fd, local.ss_family != AF_UNIX);
+    return fd;
+}
+
+int connectTo(const std::string& address) {
+    if (isUnixPath(address)) {
+        sockaddr_un addr;
+        if (!unixAddress(address, addr)) return -1;
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        configure(fd, false);
+        return fd;
+    }
+
+    addrinfo* list = resolve(address, false);
+    int       fd   = -1;
+    for (addrinfo* ai = list; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    if (list) freeaddrinfo(list);
+    if (fd >= 0) configure(fd, true);
+    return fd;
+}
+
+void closeSocket(int fd) {
+    if (fd >= 0) ::close(fd);
+}
+
+// ---------------------------------------------------------------------------
+// Connection
+// ---------------------------------------------------------------------------
+
+Connection::~Connection() {
+    close();
+}
+
+Connection::Connection(Connection&& other) noexcept
+    : m_fd(other.m_fd), m_written(other.m_written),
+      m_in(std::move(other.m_in)), m_out(std::move(other.m_out))
+{
+    other.m_fd      = -1;
+    other.m_written = 0;
+}
+
+Connection& Connection::operator=(Connection&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_fd      = other.m_fd;
+        m_written = other.m_written;
+        m_in      = std::move(other.m_in);
+        m_out     = std::move(other.m_out);
+        other.m_fd      = -1;
+        other.m_written = 0;
+    }
+    return *this;
+}
+
+void Connection::close() {
+    closeSocket(m_fd);
+    m_fd = -1;
+}
+
+bool Connection::receive() {
+    if (m_fd < 0) return false;
+    uint8_t buffer[4096];
+    while (m_in.size() < MAX_INPUT_BUFFER) {
+        const ssize_t n = recv(m_fd, buffer, std::min(sizeof buffer, MAX_INPUT_BUFFER - m_in.size()), 0);
+        if (n > 0) {
+            m_in.insert(m_in.end(), buffer, buffer + n);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        if (n < 0 && errno == EINTR) continue;
+        close(); // EOF or error
+        return false;
+    }
+    return true; // full: the rest waits in the socket until next() drains some
+}
+
+bool Connection::next(versus::MsgType& type, std::vector<uint8_t>& payload) {
+    return versus::readMessage(m_in, type, payload);
+}
+
+bool Connection::send(versus::MsgType type, const std::vector<uint8_t>& payload) {
+    if (m_fd < 0 || queued() + 3 + payload.size() > MAX_OUTPUT_BUFFER) return false;
+    versus::writeMessage(m_out, type, payload);
+    return true;
+}
+
+// Length of the frame starting at m_out[offset]
+static size_t frameSize(const std::vector<uint8_t>& out, size_t offset) {
+    return 2 + (out[offset] | (static_cast<size_t>(out[offset + 1]) << 8));
+}
+
+void Connection::dropQueued() {
+    m_out.resize(m_written > 0 ? frameSize(m_out, 0) : 0);
+}
+
+bool Connection::flush() {
+    if (m_fd < 0) return false;
+    while (m_written < m_out.size()) {
+        const ssize_t n = ::send(m_fd, m_out.data() + m_written, m_out.size() - m_written, SEND_FLAGS);
+        if (n > 0) {
+            m_written += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        close();
+        return false;
+    }
+
+    // Release whole frames only, so dropQueued() can find where the one in
+    // flight ends
+    size_t done = 0;
+    while (done < m_written && done + frameSize(m_out, done) <= m_written)
+        done += frameSize(m_out, done);
+    m_out.erase(m_out.begin(), m_out.begin() + done);
+    m_written -= done;
+    return true;
+}
+
+} // namespace net
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "versus_protocol.h"
+
+// Minimal POSIX stream sockets for versus mode. An address is "host:port"
+// for TCP (host may be empty for the listener: all interfaces) or a
+// filesystem path containing '/' for a Unix domain socket. All sockets are
+// non-blocking once set up; -1 means failure.
+namespace net {
+
+int  listenOn(const std::string& address);
+int  acceptOn(int listenFd); // -1 when no connection is pending
+int  connectTo(const std::string& address);
+void closeSocket(int fd);
+
+// Framed versus::MsgType messages over one non-blocking socket. Outgoing
+// messages are queued and written by flush(), so a slow peer never blocks
+// the caller. Both directions are bounded: receive() stops reading once
+// MAX_INPUT_BUFFER bytes are buffered (the peer is then held back by the
+// socket), and send() refuses a message that would queue more than
+// MAX_OUTPUT_BUFFER.
+class Connection {
+public:
+    // Each holds several of the largest frames, so a full buffer always has
+    // a complete message to hand out and a dropped queue always has room
+    static constexpr size_t MAX_INPUT_BUFFER  = 16 * (versus::MAX_MESSAGE + 2);
+    static constexpr size_t MAX_OUTPUT_BUFFER = 16 * (versus::MAX_MESSAGE + 2);
+
+    explicit Connection(int fd = -1) : m_fd(fd) {}
+    ~Connection();
+
+    Connection(Connection&& other) noexcept;
+    Connection& operator=(Connection&& other) noexcept;
+    Connection(const Connection&)            = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    bool isOpen() const { return m_fd >= 0; }
+    void close();
+
+    // Reads everything available; closes and returns false on EOF or error
+    bool receive();
+
+    // Next complete buffered message
+    bool next(versus::MsgType& type, std::vector<uint8_t>& payload);
+
+    // False, queueing nothing, if the connection is closed or the message
+    // would take the queue past MAX_OUTPUT_BUFFER
+    bool send(versus::MsgType type, const std::vector<uint8_t>& payload);
+
+    // Bytes queued and not yet written
+    size_t queued() const { return m_out.size() - m_written; }
+
+    // Discards every queued message the socket has not started on; a
+    // partly written one is kept so the stream stays framed
+    void dropQueued();
+
+    // Writes as much of the queue as the socket accepts; closes and returns
+    // false on error
+    bool flush();
+
+private:
+    int                  m_fd      = -1;
+    size_t               m_written = 0; // bytes at the front of m_out already sent
+    std::vector<uint8_t> m_in, m_out;
+};
+
+} // namespace net
@@ -0,0 +1,185 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include "tetromino.h"
+
+// SRS piece and kick data, plus the bitmask tables derived from it. All of
+// it is constexpr: the derived tables are built by the compiler, and code
+// that knows the piece type at compile time indexes them with constants.
+
+// ---------------------------------------------------------------------------
+// Piece rotation data — Tetris Guideline SRS
+// rotations[state][cell][x, y] — offsets from pivot
+// Row increases downward, col increases rightward
+// States: 0=spawn, 1=CW90, 2=180, 3=CCW90
+// ---------------------------------------------------------------------------
+
+inline constexpr TetrominoData TETROMINO_DATA[7] = {
+    // I — cyan
+    { { { {-1,0},{0,0},{1,0},{2,0} },
+        { {1,-1},{1,0},{1,1},{1,2} },
+        { {-1,1},{0,1},{1,1},{2,1} },
+        { {0,-1},{0,0},{0,1},{0,2} } },
+      Color{0, 240, 240} },
+
+    // J — blue
+    { { { {-1,-1},{-1,0},{0,0},{1,0} },
+        { {0,-1},{1,-1},{0,0},{0,1} },
+        { {-1,0},{0,0},{1,0},{1,1} },
+        { {0,-1},{0,0},{-1,1},{0,1} } },
+      Color{0, 0, 240} },
+
+    // L — orange
+    { { { {-1,0},{0,0},{1,0},{1,-1} },
+        { {0,-1},{0,0},{0,1},{1,1} },
+        { {-1,1},{-1,0},{0,0},{1,0} },
+        { {-1,-1},{0,-1},{0,0},{0,1} } },
+      Color{240, 160, 0} },
+
+    // O — yellow (all states identical)
+    { { { {0,-1},{1,-1},{0,0},{1,0} },
+        { {0,-1},{1,-1},{0,0},{1,0} },
+        { {0,-1},{1,-1},{0,0},{1,0} },
+        { {0,-1},{1,-1},{0,0},{1,0} } },
+      Color{240, 240, 0} },
+
+    // S — green
+    { { { {-1,0},{0,0},{0,-1},{1,-1} },
+        { {0,-1},{0,0},{1,0},{1,1} },
+        { {-1,1},{0,1},{0,0},{1,0} },
+        { {-1,-1},{-1,0},{0,0},{0,1} } },
+      Color{0, 240, 0} },
+
+    // T — purple
+    { { { {-1,0},{0,0},{1,0},{0,-1} },
+        { {0,-1},{0,0},{1,0},{0,1} },
+        { {-1,0},{0,0},{1,0},{0,1} },
+        { {0,-1},{-1,0},{0,0},{0,1} } },
+      Color{160, 0, 240} },
+
+    // Z — red
+    { { { {-1,-1},{0,-1},{0,0},{1,0} },
+        { {1,-1},{0,0},{1,0},{0,1} },
+        { {-1,0},{0,0},{0,1},{1,1} },
+        { {0,-1},{-1,0},{0,0},{-1,1} } },
+      Color{240, 0, 0} },
+};
+
+// ---------------------------------------------------------------------------
+// SRS Wall Kick Tables — Tetris Guideline
+// offsets[from_rotation_state][kick_attempt_0..4][x, y]
+// ---------------------------------------------------------------------------
+
+// J, L, S, T, Z — clockwise kicks
+inline constexpr KickData SRS_KICKS_JLSTZ_CW = { {
+    { {0,0},{-1,0},{-1,-1},{0,2},{-1,2} },  // 0->1
+    { {0,0},{1,0},{1,1},{0,-2},{1,-2} },    // 1->2
+    { {0,0},{1,0},{1,-1},{0,2},{1,2} },     // 2->3
+    { {0,0},{-1,0},{-1,1},{0,-2},{-1,-2} }, // 3->0
+} };
+
+// J, L, S, T, Z — counter-clockwise kicks
+inline constexpr KickData SRS_KICKS_JLSTZ_CCW = { {
+    { {0,0},{1,0},{1,-1},{0,2},{1,2} },     // 0->3
+    { {0,0},{1,0},{1,1},{0,-2},{1,-2} },    // 1->0
+    { {0,0},{-1,0},{-1,-1},{0,2},{-1,2} },  // 2->1
+    { {0,0},{-1,0},{-1,1},{0,-2},{-1,-2} }, // 3->2
+} };
+
+// I — clockwise kicks
+inline constexpr KickData SRS_KICKS_I_CW = { {
+    { {0,0},{-2,0},{1,0},{-2,1},{1,-2} },   // 0->1
+    { {0,0},{-1,0},{2,0},{-1,-2},{2,1} },   // 1->2
+    { {0,0},{2,0},{-1,0},{2,-1},{-1,2} },   // 2->3
+    { {0,0},{1,0},{-2,0},{1,2},{-2,-1} },   // 3->0
+} };
+
+// I — counter-clockwise kicks
+inline constexpr KickData SRS_KICKS_I_CCW = { {
+    { {0,0},{-1,0},{2,0},{-1,-2},{2,1} },   // 0->3
+    { {0,0},{2,0},{-1,0},{2,-1},{-1,2} },   // 1->0
+    { {0,0},{1,0},{-2,0},{1,2},{-2,-1} },   // 2->1
+    { {0,0},{-2,0},{1,0},{-2,1},{1,-2} },   // 3->2
+} };
+
+// SRS kick table for a rotation of the given piece; direction +1 CW, -1 CCW.
+// Returns nullptr for the O piece, which does not rotate.
+constexpr const KickData* kickDataFor(TetrominoType type, int direction) {
+    switch (type) {
+        case TetrominoType::O: return nullptr;
+        case TetrominoType::I: return (direction > 0) ? &SRS_KICKS_I_CW : &SRS_KICKS_I_CCW;
+        default:               return (direction > 0) ? &SRS_KICKS_JLSTZ_CW : &SRS_KICKS_JLSTZ_CCW;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Row bitmasks derived from TETROMINO_DATA — used by Board collision tests
+// ---------------------------------------------------------------------------
+
+// Evaluated at compile time; constexpr rules out std::min/std::fill here
+constexpr std::array<std::array<PieceMask, 4>, 7> buildPieceMasks() {
+    std::array<std::array<PieceMask, 4>, 7> masks{};
+    for (int t = 0; t < 7; ++t) {
+        for (int r = 0; r < 4; ++r) {
+            const auto& cells = TETROMINO_DATA[t].rotations[r];
+            PieceMask& m = masks[t][r];
+            m.minX = m.maxX = cells[0][0];
+            m.minY = cells[0][1];
+            int maxY = cells[0][1];
+            for (int i = 1; i < 4; ++i) {
+                m.minX = cells[i][0] < m.minX ? cells[i][0] : m.minX;
+                m.maxX = cells[i][0] > m.maxX ? cells[i][0] : m.maxX;
+                m.minY = cells[i][1] < m.minY ? cells[i][1] : m.minY;
+                maxY   = cells[i][1] > maxY   ? cells[i][1] : maxY;
+            }
+            m.height = maxY - m.minY + 1;
+            for (int i = 0; i < 4; ++i)
+                m.rows[cells[i][1] - m.minY] |=
+                    static_cast<uint16_t>(1u << (cells[i][0] - m.minX));
+            // Columns past maxX - minX are unused
+            for (int& bottom : m.bottoms) bottom = m.minY;
+            for (int i = 0; i < 4; ++i) {
+                int& bottom = m.bottoms[cells[i][0] - m.minX];
+                bottom = cells[i][1] > bottom ? cells[i][1] : bottom;
+            }
+        }
+    }
+    return masks;
+}
+
+inline constexpr std::array<std::array<PieceMask, 4>, 7> PIECE_MASKS = buildPieceMasks();
+
+constexpr const PieceMask& pieceMask(TetrominoType type, int rotation) {
+    return PIECE_MASKS[static_cast<int>(type)][rotation & 3];
+}
+
+// ---------------------------------------------------------------------------
+// Per-type constants for code specialized on TetrominoType
+// ---------------------------------------------------------------------------
+
+// Rows spanned by the tallest rotation state of T
+template <TetrominoType T>
+inline constexpr int PIECE_HEIGHT = T == TetrominoType::I ? 4 : T == TetrominoType::O ? 2 : 3;
+
+// SRS kicks for T indexed by direction > 0 (CCW, CW); both nullptr for O
+template <TetrominoType T>
+inline constexpr const KickData* PIECE_KICKS[2] = {kickDataFor(T, -1), kickDataFor(T, 1)};
+
+template <TetrominoType T>
+using PieceTypeTag = std::integral_constant<TetrominoType, T>;
+
+// Calls fn(PieceTypeTag<type>{}) so a runtime type picks a specialization
+// once, outside the loop that uses it
+template <typename Fn>
+decltype(auto) withPieceType(TetrominoType type, Fn&& fn) {
+    switch (type) {
+        case TetrominoType::I: return fn(PieceTypeTag<TetrominoType::I>{});
+        case TetrominoType::J: return fn(PieceTypeTag<TetrominoType::J>{});
+        case TetrominoType::L: return fn(PieceTypeTag<TetrominoType::L>{});
+        case TetrominoType::O: return fn(PieceTypeTag<TetrominoType::O>{});
+        case TetrominoType::S: return fn(PieceTypeTag<TetrominoType::S>{});
+        case TetrominoType::T: return fn(PieceTypeTag<TetrominoType::T>{});
+        default:               return fn(PieceTypeTag<TetrominoType::Z>{});
+    }
+}
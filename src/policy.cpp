@@ -0,0 +1,278 @@
+#include "policy.h"
+#include <algorithm>
+#include <cstring>
+
+uint16_t actionsFor(Move move) {
+    switch (move) {
+        case Move::Left:      return actionBit(Action::MoveLeft);
+        case Move::Right:     return actionBit(Action::MoveRight);
+        case Move::SoftDrop:  return actionBit(Action::SoftDrop);
+        case Move::RotateCW:  return actionBit(Action::RotateCW);
+        case Move::RotateCCW: return actionBit(Action::RotateCCW);
+        case Move::HardDrop:  return actionBit(Action::HardDrop);
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// PathExecutor
+// ---------------------------------------------------------------------------
+
+void PathExecutor::start(const std::array<Move, MoveGenerator::MAX_PATH>& path, int length) {
+    m_path    = path;
+    m_length  = length;
+    m_index   = 0;
+    m_dropRow = -1;
+}
+
+uint16_t PathExecutor::next(const Game& game) {
+    if (done()) return 0;
+
+    const Move move = m_path[m_index];
+    if (move == Move::Left || move == Move::Right) {
+        // A run of shifts goes out as one tick's move repeats, so gravity
+        // gets fewer ticks to pull the piece off the planned path
+        int run = 1;
+        while (m_index + run < m_length && m_path[m_index + run] == move && run < MAX_MOVE_REPEATS)
+            ++run;
+        m_index += run;
+        return withMoveRepeats(actionsFor(move), run);
+    }
+    if (move != Move::SoftDrop) {
+        ++m_index;
+        return actionsFor(move);
+    }
+
+    const int row = game.current().position().y;
+    if (m_dropRow < 0) m_dropRow = row;
+    if (row > m_dropRow) {
+        // Dropped a row since the previous tick; move on to the next input
+        m_dropRow = -1;
+        ++m_index;
+        return next(game);
+    }
+    return actionsFor(Move::SoftDrop);
+}
+
+// ---------------------------------------------------------------------------
+// RandomPolicy
+// ---------------------------------------------------------------------------
+
+RandomPolicy::RandomPolicy(uint32_t seed)
+    : m_gen(std::make_shared<MoveGenerator>()), m_rng(seed)
+{}
+
+uint16_t RandomPolicy::operator()(const Game& game) {
+    if (game.pieces() != m_plannedFor) {
+        m_plannedFor = game.pieces();
+
+        std::array<Move, MoveGenerator::MAX_PATH> path;
+        int count  = m_gen->generate(game.board(), game.current());
+        int length = 0;
+        if (count > 0) {
+            std::uniform_int_distribution<int> pick(0, count - 1);
+            length = m_gen->pathTo(pick(m_rng), path);
+        }
+        if (length == 0) {
+            path[0] = Move::HardDrop;
+            length  = 1;
+        }
+        m_exec.start(path, length);
+    }
+
+    uint16_t actions = m_exec.next(game);
+    return actions ? actions : actionBit(Action::HardDrop);
+}
+
+// ---------------------------------------------------------------------------
+// BeamSearchPolicy
+// ---------------------------------------------------------------------------
+
+static constexpr int   PREVIEW     = 3; // Game::nextPieces() length
+static constexpr int   EXPAND_ROOT = -2;
+static constexpr float TOPPED_OUT  = -1e9f;
+
+// Tags plan entries so they never share a key with a board's evaluation
+static constexpr uint64_t PLAN_TAG = 0xD6E8FEB86659FD93ull;
+
+// A piece as Game::spawnPiece places it
+static Tetromino spawned(TetrominoType type) {
+    Tetromino piece(type);
+    piece.setPosition(SPAWN_POSITION);
+    return piece;
+}
+
+BeamSearchPolicy::BeamSearchPolicy(BeamConfig config)
+    : m_config(config), m_search(std::make_shared<Search>())
+{
+    m_config.width = std::max(1, m_config.width);
+    m_config.depth = std::max(1, m_config.depth);
+}
+
+float BeamSearchPolicy::evaluateCached(const Board& board) {
+    const uint64_t key = board.hash();
+    uint64_t       bits;
+    float          value;
+    if (m_search->table.probe(key, bits)) {
+        const uint32_t low = static_cast<uint32_t>(bits);
+        std::memcpy(&value, &low, sizeof value);
+        return value;
+    }
+    value = evaluate(computeFeatures(board), m_config.weights);
+    uint32_t low;
+    std::memcpy(&low, &value, sizeof low);
+    m_search->table.store(key, low);
+    return value;
+}
+
+void BeamSearchPolicy::expand(const Node& parent, const Tetromino& piece, int8_t hold,
+                              int8_t next, int rootMove, const TetrominoType* sequence,
+                              int length) {
+    MoveGenerator& gen   = m_search->gen;
+    const int      count = gen.generate(parent.board, piece);
+    for (int i = 0; i < count; ++i) {
+        const Placement& p = gen.placement(i);
+        Tetromino placed(piece.type());
+        placed.setRotation(p.rotation);
+        placed.setPosition(p.position);
+
+        m_search->children.push_back(parent);
+        Node&     child   = m_search->children.back();
+        const int cleared = child.board.lockPiece(placed);
+
+        child.hold     = hold;
+        child.next     = next;
+        child.rootMove = static_cast<int16_t>(rootMove < -1 ? i : rootMove);
+        child.reward  += m_config.weights.lines[cleared];
+        child.key      = child.board.hash()
+                       ^ (static_cast<uint64_t>(hold + 1) * 0x9E3779B97F4A7C15ull)
+                       ^ (static_cast<uint64_t>(next) << 56);
+
+        // Same condition as Game::spawnPiece: a blocked spawn ends the game
+        const bool spawnBlocked = next < length &&
+            !child.board.isValidPosition(spawned(sequence[next]), SPAWN_POSITION, 0);
+        child.score = spawnBlocked
+            ? TOPPED_OUT
+            : child.reward + evaluateCached(child.board);
+    }
+}
+
+int BeamSearchPolicy::plan(const Game& game) {
+    // Game::hash() covers the board, hold and queue; the pose covers the
+    // rest of what the search depends on
+    const Tetromino& current = game.current();
+    const uint64_t   pose    = static_cast<uint64_t>(current.position().x + 8)
+                             | static_cast<uint64_t>(current.position().y + 8) << 8
+                             | static_cast<uint64_t>(current.rotationState()) << 16;
+    const uint64_t   planKey = game.hash() ^ PLAN_TAG ^ pose * 0x9E3779B97F4A7C15ull;
+    uint64_t         cached;
+    if (m_search->table.probe(planKey, cached)) return static_cast<int>(cached) - 1;
+
+    const int move = runSearch(game);
+    m_search->table.store(planKey, static_cast<uint64_t>(move + 1));
+    return move;
+}
+
+int BeamSearchPolicy::runSearch(const Game& game) {
+    TetrominoType sequence[1 + PREVIEW];
+    sequence[0] = game.current().type();
+    const auto preview = game.nextPieces();
+    std::copy(preview.begin(), preview.end(), sequence + 1);
+    const int length = 1 + PREVIEW;
+
+    auto& beam     = m_search->beam;
+    auto& children = m_search->children;
+
+    Node root;
+    root.board    = game.board();
+    root.key      = 0;
+    root.reward   = 0.f;
+    root.score    = 0.f;
+    root.rootMove = -1;
+    root.hold     = game.held() ? static_cast<int8_t>(game.held()->type()) : -1;
+    root.next     = 1;
+
+    // Depth 0 places the piece in play as it stands (it may have moved since
+    // spawning); holding swaps in a piece that starts fresh at the spawn
+    children.clear();
+    expand(root, game.current(), root.hold, 1, EXPAND_ROOT, sequence, length);
+    if (!game.holdUsed()) {
+        const int8_t current = static_cast<int8_t>(sequence[0]);
+        if (root.hold >= 0)
+            expand(root, spawned(static_cast<TetrominoType>(root.hold)), current, 1, -1,
+                   sequence, length);
+        else
+            expand(root, spawned(sequence[1]), current, 2, -1, sequence, length);
+    }
+
+    auto&      order   = m_search->order;
+    const auto byScore = [&](int a, int b) { return children[a].score > children[b].score; };
+    for (int depth = 1;; ++depth) {
+        // Keep the best `width` distinct positions: different move orders
+        // often reach the same stack with the same hold and queue. Sorting
+        // indices avoids moving whole boards around.
+        order.resize(children.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+        std::sort(order.begin(), order.end(), byScore);
+        beam.clear();
+        for (int i : order) {
+            if (static_cast<int>(beam.size()) >= m_config.width) break;
+            bool duplicate = false;
+            for (const Node& kept : beam)
+                if (kept.key == children[i].key) { duplicate = true; break; }
+            if (!duplicate) beam.push_back(children[i]);
+        }
+        if (beam.empty()) return 0;
+        if (depth >= m_config.depth) break;
+
+        children.clear();
+        bool expanded = false;
+        for (const Node& n : beam) {
+            if (n.score <= TOPPED_OUT || n.next >= length) {
+                children.push_back(n); // nothing left to place: carry over
+                continue;
+            }
+            expanded = true;
+            const TetrominoType piece = sequence[n.next];
+            expand(n, spawned(piece), n.hold, static_cast<int8_t>(n.next + 1),
+                   n.rootMove, sequence, length);
+            if (n.hold >= 0)
+                expand(n, spawned(static_cast<TetrominoType>(n.hold)),
+                       static_cast<int8_t>(piece), static_cast<int8_t>(n.next + 1),
+                       n.rootMove, sequence, length);
+            else if (n.next + 1 < length)
+                expand(n, spawned(sequence[n.next + 1]), static_cast<int8_t>(piece),
+                       static_cast<int8_t>(n.next + 2), n.rootMove, sequence, length);
+        }
+        if (!expanded) break;
+    }
+    return beam.front().rootMove;
+}
+
+uint16_t BeamSearchPolicy::operator()(const Game& game) {
+    // A hold swaps the piece without locking one, so replan on either
+    if (game.pieces() != m_plannedFor || game.holdUsed() != m_plannedHeld) {
+        m_plannedFor  = game.pieces();
+        m_plannedHeld = game.holdUsed();
+
+        const int move = plan(game);
+        if (move < 0) {
+            m_exec.start({}, 0);
+            return actionBit(Action::Hold);
+        }
+
+        // plan() reused the generator; the root expansion is deterministic,
+        // so regenerating it restores the same placement indices
+        std::array<Move, MoveGenerator::MAX_PATH> path;
+        m_search->gen.generate(game.board(), game.current());
+        int length = m_search->gen.pathTo(move, path);
+        if (length == 0) {
+            path[0] = Move::HardDrop;
+            length  = 1;
+        }
+        m_exec.start(path, length);
+    }
+
+    uint16_t actions = m_exec.next(game);
+    return actions ? actions : actionBit(Action::HardDrop);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+#include "evaluator.h"
+#include "game.h"
+#include "movegen.h"
+#include "transposition_table.h"
+
+// Per-tick controller for one game: returns the actions for the next step()
+using Policy = std::function<uint16_t(const Game&)>;
+
+// Builds an independent Policy for the game played with the given seed
+using PolicyFactory = std::function<Policy(uint32_t seed)>;
+
+// Game::step actions that perform one generator Move
+uint16_t actionsFor(Move move);
+
+// Feeds a MoveGenerator path to Game::step one move per tick, except that a
+// run of sideways shifts goes out in a single tick via withMoveRepeats. A
+// SoftDrop move is held until the piece has actually dropped a row.
+class PathExecutor {
+public:
+    void start(const std::array<Move, MoveGenerator::MAX_PATH>& path, int length);
+
+    bool     done() const { return m_index >= m_length; }
+    uint16_t next(const Game& game);
+
+private:
+    std::array<Move, MoveGenerator::MAX_PATH> m_path{};
+    int m_length  = 0;
+    int m_index   = 0;
+    int m_dropRow = -1; // row the current SoftDrop started from
+};
+
+// Drops every piece into a uniformly random reachable placement. Cheap
+// baseline for throughput runs; tops out after a few dozen pieces.
+class RandomPolicy {
+public:
+    explicit RandomPolicy(uint32_t seed);
+
+    uint16_t operator()(const Game& game);
+
+private:
+    // Shared so the Policy std::function stays cheap to copy
+    std::shared_ptr<MoveGenerator> m_gen;
+    std::mt19937                   m_rng;
+    PathExecutor                   m_exec;
+    int                            m_plannedFor = -1; // Game::pieces() at planning time
+};
+
+struct BeamConfig {
+    int         width = 16; // nodes kept per depth
+    int         depth = 4;  // pieces placed per search: current + preview
+    EvalWeights weights;
+};
+
+// Beam search over the current piece, the nextPieces() preview and the hold
+// slot, scoring each stack with computeFeatures/evaluate. Plans once per
+// piece and plays the best first placement through PathExecutor; a hold is
+// sent on its own tick and the swapped-in piece is searched afresh.
+// Evaluations are cached by Board::hash() and finished plans by Game::hash()
+// plus the piece's pose, so stacks reached again are not rescored.
+class BeamSearchPolicy {
+public:
+    explicit BeamSearchPolicy(BeamConfig config = {});
+
+    uint16_t operator()(const Game& game);
+
+private:
+    struct Node {
+        Board    board;
+        uint64_t key;      // board hash mixed with hold and queue position
+        float    reward;   // line-clear rewards along the way
+        float    score;    // reward + evaluation of board
+        int16_t  rootMove; // placement of the current piece that led here, -1 = hold first
+        int8_t   hold;     // held TetrominoType, -1 = empty
+        int8_t   next;     // index into the piece sequence of the next piece to place
+    };
+
+    struct Search {
+        MoveGenerator      gen;
+        std::vector<Node>  beam, children;
+        std::vector<int>   order; // children indices, best first
+        TranspositionTable table{1 << 16};
+    };
+
+    // evaluate(computeFeatures(board)) through the table
+    float evaluateCached(const Board& board);
+
+    // Returns the placement index for the current piece, or -1 to hold first
+    int  plan(const Game& game);
+    int  runSearch(const Game& game); // plan() without the table
+
+    // Appends a child of parent for every placement of piece. rootMove < -1
+    // tags each child with its own placement index (expanding the root).
+    void expand(const Node& parent, const Tetromino& piece, int8_t hold, int8_t next,
+                int rootMove, const TetrominoType* sequence, int length);
+
+    BeamConfig              m_config;
+    std::shared_ptr<Search> m_search; // shared so the Policy std::function stays cheap to copy
+    PathExecutor            m_exec;
+    int                     m_plannedFor  = -1; // Game::pieces() at planning time
+    bool                    m_plannedHeld = false;
+};
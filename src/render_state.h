@@ -0,0 +1,33 @@
+#pragma once
+#include <array>
+#include "board.h"
+#include "game.h"
+#include "tetromino.h"
+
+// Everything the Renderer reads from a Game, copied by value so a frame can
+// be drawn while the simulation thread keeps stepping the live Game
+struct RenderState {
+    Board                        board;
+    Tetromino                    current{TetrominoType::I};
+    int                          ghostRow = 0;
+    bool                         hasHeld  = false;
+    TetrominoType                held     = TetrominoType::I;
+    bool                         holdUsed = false;
+    std::array<TetrominoType, 3> next{};
+    ScoreState                   score;
+    GameState                    state    = GameState::Playing;
+    int                          garbage  = 0; // queued versus garbage lines
+
+    void capture(const Game& game) {
+        board    = game.board();
+        current  = game.current();
+        ghostRow = game.ghostRow();
+        hasHeld  = game.held() != nullptr;
+        if (hasHeld) held = game.held()->type();
+        holdUsed = game.holdUsed();
+        next     = game.nextPieces();
+        score    = game.score();
+        state    = game.state();
+        garbage  = game.pendingGarbage();
+    }
+};
@@ -1,13 +1,19 @@
 #include "renderer.h"
+#include <algorithm>
 #include <string>
 
 Renderer::Renderer(sf::RenderWindow& window, int boardOriginX, int boardOriginY)
     : m_window(window), m_originX(boardOriginX), m_originY(boardOriginY)
-{}
+{
+    buildFrame();
+    m_stackReady = m_stack.resize({static_cast<unsigned>(BOARD_W),
+                                   static_cast<unsigned>(BOARD_H)});
+}
 
 bool Renderer::loadFont(const std::string& path) {
     if (m_font.openFromFile(path)) {
         m_fontLoaded = true;
+        buildText();
         return true;
     }
     return false;
@@ -25,203 +31,292 @@ sf::Vector2f Renderer::boardToScreen(int col, int row) const {
     };
 }
 
-sf::RectangleShape Renderer::makeCell(float x, float y, sf::Color color, uint8_t alpha) const {
-    sf::RectangleShape rect({static_cast<float>(Game::CELL_PX - 1),
-                              static_cast<float>(Game::CELL_PX - 1)});
-    rect.setPosition({x, y});
+sf::Color Renderer::toSfColor(Color c) {
+    return sf::Color(c.r, c.g, c.b, c.a);
+}
+
+// ---------------------------------------------------------------------------
+// Batch helpers
+// ---------------------------------------------------------------------------
+
+void Renderer::addQuad(sf::VertexArray& batch, float x, float y, float w, float h, sf::Color color) {
+    const sf::Vector2f tl{x, y}, tr{x + w, y}, bl{x, y + h}, br{x + w, y + h};
+    batch.append({tl, color, {}});
+    batch.append({tr, color, {}});
+    batch.append({bl, color, {}});
+    batch.append({bl, color, {}});
+    batch.append({tr, color, {}});
+    batch.append({br, color, {}});
+}
+
+// Outline drawn outside the rectangle, like sf::Shape::setOutlineThickness
+void Renderer::addOutline(sf::VertexArray& batch, float x, float y, float w, float h,
+                          float t, sf::Color color) {
+    addQuad(batch, x - t, y - t, w + 2 * t, t, color); // top
+    addQuad(batch, x - t, y + h, w + 2 * t, t, color); // bottom
+    addQuad(batch, x - t, y,     t,         h, color); // left
+    addQuad(batch, x + w, y,     t,         h, color); // right
+}
+
+void Renderer::addCell(sf::VertexArray& batch, float x, float y, sf::Color color, uint8_t alpha) {
     color.a = alpha;
-    rect.setFillColor(color);
-    return rect;
+    addQuad(batch, x, y, Game::CELL_PX - 1.f, Game::CELL_PX - 1.f, color);
 }
 
 // ---------------------------------------------------------------------------
 // Text helpers
 // ---------------------------------------------------------------------------
 
-void Renderer::drawLabel(const std::string& text, float x, float y, unsigned size) {
-    if (!m_fontLoaded) return;
+sf::Text Renderer::makeLabel(const std::string& text, float x, float y, unsigned size) const {
     sf::Text t(m_font, text, size);
     t.setFillColor(sf::Color(180, 180, 180));
     t.setPosition({x, y});
-    m_window.draw(t);
+    return t;
 }
 
-void Renderer::drawValue(const std::string& text, float x, float y, unsigned size) {
-    if (!m_fontLoaded) return;
-    sf::Text t(m_font, text, size);
+sf::Text Renderer::makeValue(float x, float y, unsigned size) const {
+    sf::Text t(m_font, "", size);
     t.setFillColor(sf::Color::White);
     t.setPosition({x, y});
-    m_window.draw(t);
+    return t;
+}
+
+void Renderer::drawValue(ValueText& value, int number) {
+    if (!value.text) return;
+    if (number != value.shown) {
+        value.text->setString(std::to_string(number));
+        value.shown = number;
+    }
+    m_window.draw(*value.text);
 }
 
 // ---------------------------------------------------------------------------
-// Draw methods
+// Geometry
 // ---------------------------------------------------------------------------
 
-void Renderer::drawBackground() {
+void Renderer::buildFrame() {
+    const float ox = static_cast<float>(m_originX);
+    const float oy = static_cast<float>(m_originY);
+    const sf::Color outline(60, 60, 80);
+    const sf::Color panel(20, 20, 35);
+    const sf::Color grid(30, 30, 45);
+
+    m_frame.clear();
+
     // Board area
-    sf::RectangleShape boardBg({static_cast<float>(BOARD_W), static_cast<float>(BOARD_H)});
-    boardBg.setPosition({static_cast<float>(m_originX), static_cast<float>(m_originY)});
-    boardBg.setFillColor(sf::Color(15, 15, 25));
-    boardBg.setOutlineColor(sf::Color(60, 60, 80));
-    boardBg.setOutlineThickness(2.f);
-    m_window.draw(boardBg);
+    addQuad(m_frame, ox, oy, BOARD_W, BOARD_H, sf::Color(15, 15, 25));
+    addOutline(m_frame, ox, oy, BOARD_W, BOARD_H, 2.f, outline);
 
     // Grid lines
-    for (int r = 1; r < BOARD_ROWS; ++r) {
-        sf::RectangleShape line({static_cast<float>(BOARD_W), 1.f});
-        line.setPosition({static_cast<float>(m_originX),
-                          static_cast<float>(m_originY + r * Game::CELL_PX)});
-        line.setFillColor(sf::Color(30, 30, 45));
-        m_window.draw(line);
-    }
-    for (int c = 1; c < BOARD_COLS; ++c) {
-        sf::RectangleShape line({1.f, static_cast<float>(BOARD_H)});
-        line.setPosition({static_cast<float>(m_originX + c * Game::CELL_PX),
-                          static_cast<float>(m_originY)});
-        line.setFillColor(sf::Color(30, 30, 45));
-        m_window.draw(line);
-    }
+    for (int r = 1; r < BOARD_ROWS; ++r)
+        addQuad(m_frame, ox, oy + r * Game::CELL_PX, BOARD_W, 1.f, grid);
+    for (int c = 1; c < BOARD_COLS; ++c)
+        addQuad(m_frame, ox + c * Game::CELL_PX, oy, 1.f, BOARD_H, grid);
 
     // Left panel (hold)
-    sf::RectangleShape leftPanel({static_cast<float>(PANEL_W - 8), 120.f});
-    leftPanel.setPosition({static_cast<float>(m_originX - PANEL_W + 4),
-                           static_cast<float>(m_originY + 30)});
-    leftPanel.setFillColor(sf::Color(20, 20, 35));
-    leftPanel.setOutlineColor(sf::Color(60, 60, 80));
-    leftPanel.setOutlineThickness(1.f);
-    m_window.draw(leftPanel);
+    const float lx = ox - PANEL_W + 4;
+    addQuad(m_frame, lx, oy + 30, PANEL_W - 8, 120.f, panel);
+    addOutline(m_frame, lx, oy + 30, PANEL_W - 8, 120.f, 1.f, outline);
 
     // Right panel (next)
-    sf::RectangleShape rightPanel({static_cast<float>(PANEL_W - 8), 360.f});
-    rightPanel.setPosition({static_cast<float>(m_originX + BOARD_W + 4),
-                            static_cast<float>(m_originY + 30)});
-    rightPanel.setFillColor(sf::Color(20, 20, 35));
-    rightPanel.setOutlineColor(sf::Color(60, 60, 80));
-    rightPanel.setOutlineThickness(1.f);
-    m_window.draw(rightPanel);
+    const float rx = ox + BOARD_W + 4;
+    addQuad(m_frame, rx, oy + 30, PANEL_W - 8, 360.f, panel);
+    addOutline(m_frame, rx, oy + 30, PANEL_W - 8, 360.f, 1.f, outline);
 }
 
-void Renderer::drawBoard(const Board& board) {
+// offset is subtracted from screen positions (the stack texture's origin)
+void Renderer::addBoard(const Board& board, sf::VertexArray& batch, sf::Vector2f offset) {
     for (int r = 2; r < BOARD_ROWS_TOTAL; ++r) {
+        if (!board.rowMask(r)) continue;
         for (int c = 0; c < BOARD_COLS; ++c) {
-            sf::Color color = board.cellColor(c, r);
+            Color color = board.cellColor(c, r);
             if (color == EMPTY_COLOR) continue;
             auto [sx, sy] = boardToScreen(c, r);
-            m_window.draw(makeCell(sx, sy, color));
+            addCell(batch, sx - offset.x, sy - offset.y, toSfColor(color));
         }
     }
 }
 
-void Renderer::drawGhost(const Tetromino& current, int ghostDist) {
-    sf::Vector2i ghostPos = current.position() + sf::Vector2i{0, ghostDist};
+void Renderer::drawStack(const Board& board) {
+    const sf::Vector2f origin{static_cast<float>(m_originX), static_cast<float>(m_originY)};
+
+    if (!m_stackReady) {
+        // No offscreen target available: draw the cells with the frame's batch
+        addBoard(board, m_cells, {0.f, 0.f});
+        return;
+    }
+
+    if (!m_stackValid || board.version() != m_stackVersion) {
+        m_stackCells.clear();
+        addBoard(board, m_stackCells, origin);
+        m_stack.clear(sf::Color::Transparent);
+        m_stack.draw(m_stackCells);
+        m_stack.display();
+        m_stackVersion = board.version();
+        m_stackValid   = true;
+    }
+
+    sf::Sprite sprite(m_stack.getTexture());
+    sprite.setPosition(origin);
+    m_window.draw(sprite);
+}
+
+void Renderer::addGhost(const Tetromino& current, int ghostDist) {
+    Vec2i ghostPos = current.position() + Vec2i{0, ghostDist};
     const auto cells = current.worldCellsAt(ghostPos, current.rotationState());
-    sf::Color ghostColor = current.color();
+    sf::Color ghostColor = toSfColor(current.color());
     for (const auto& c : cells) {
         if (c.y < 2) continue; // skip hidden rows
         auto [sx, sy] = boardToScreen(c.x, c.y);
-        m_window.draw(makeCell(sx, sy, ghostColor, 60));
+        addCell(m_cells, sx, sy, ghostColor, 60);
     }
 }
 
-void Renderer::drawPiece(const Tetromino& piece, sf::Vector2i screenOffset, uint8_t alpha) {
+void Renderer::addPiece(const Tetromino& piece, uint8_t alpha) {
     for (const auto& c : piece.worldCells()) {
         if (c.y < 2) continue;
         auto [sx, sy] = boardToScreen(c.x, c.y);
-        m_window.draw(makeCell(sx + screenOffset.x, sy + screenOffset.y, piece.color(), alpha));
+        addCell(m_cells, sx, sy, toSfColor(piece.color()), alpha);
     }
 }
 
-void Renderer::drawPiecePreview(TetrominoType type, sf::Vector2f center, uint8_t alpha) {
+void Renderer::addPiecePreview(TetrominoType type, sf::Vector2f center, uint8_t alpha) {
     Tetromino tmp(type);
-    sf::Color color = tmp.color();
+    sf::Color color = toSfColor(tmp.color());
     const auto& rot = TETROMINO_DATA[static_cast<int>(type)].rotations[0];
     for (int i = 0; i < 4; ++i) {
         float px = center.x + rot[i][0] * Game::CELL_PX;
         float py = center.y + rot[i][1] * Game::CELL_PX;
-        m_window.draw(makeCell(px - Game::CELL_PX / 2.f,
-                                py - Game::CELL_PX / 2.f,
-                                color, alpha));
+        addCell(m_cells, px - Game::CELL_PX / 2.f, py - Game::CELL_PX / 2.f, color, alpha);
     }
 }
 
-void Renderer::drawHoldSlot(const Game& game) {
+void Renderer::addHoldSlot(const RenderState& state) {
     float lx = static_cast<float>(m_originX - PANEL_W + 4);
     float ly = static_cast<float>(m_originY);
-    drawLabel("HOLD", lx + 8, ly + 6, 14);
 
-    uint8_t alpha = game.holdUsed() ? 80 : 255;
+    uint8_t alpha = state.holdUsed ? 80 : 255;
 
-    if (game.held()) {
-        drawPiecePreview(game.held()->type(),
-                         {lx + PANEL_W / 2.f - 8, ly + 80.f},
-                         alpha);
+    if (state.hasHeld) {
+        addPiecePreview(state.held,
+                        {lx + PANEL_W / 2.f - 8, ly + 80.f},
+                        alpha);
     }
 }
 
-void Renderer::drawNextPieces(const std::array<TetrominoType, 3>& next) {
+void Renderer::addNextPieces(const std::array<TetrominoType, 3>& next) {
     float rx = static_cast<float>(m_originX + BOARD_W + 4);
     float ry = static_cast<float>(m_originY);
-    drawLabel("NEXT", rx + 8, ry + 6, 14);
 
     for (int i = 0; i < 3; ++i) {
         float cy = ry + 70.f + i * 110.f;
-        drawPiecePreview(next[i], {rx + PANEL_W / 2.f - 8, cy});
+        addPiecePreview(next[i], {rx + PANEL_W / 2.f - 8, cy});
     }
 }
 
-void Renderer::drawUI(const ScoreState& score, GameState state) {
-    // Score panel below the right next panel
+void Renderer::addOverlay(GameState state) {
+    // Dim the board under the PAUSED / GAME OVER text
+    if (state == GameState::Playing) return;
+    uint8_t alpha = (state == GameState::Paused) ? 160 : 180;
+    addQuad(m_cells, static_cast<float>(m_originX), static_cast<float>(m_originY),
+            BOARD_W, BOARD_H, sf::Color(0, 0, 0, alpha));
+}
+
+// ---------------------------------------------------------------------------
+// Text
+// ---------------------------------------------------------------------------
+
+void Renderer::buildText() {
+    float lx = static_cast<float>(m_originX - PANEL_W + 4);
     float rx = static_cast<float>(m_originX + BOARD_W + 4);
+    float ty = static_cast<float>(m_originY);
+
+    // Score panel below the right next panel
     float ry = static_cast<float>(m_originY + 400);
 
-    drawLabel("SCORE", rx + 8, ry);
-    drawValue(std::to_string(score.score), rx + 8, ry + 18);
+    m_labels.clear();
+    m_labels.push_back(makeLabel("HOLD", lx + 8, ty + 6, 14));
+    m_labels.push_back(makeLabel("NEXT", rx + 8, ty + 6, 14));
+    m_labels.push_back(makeLabel("SCORE", rx + 8, ry));
+    m_labels.push_back(makeLabel("LEVEL", rx + 8, ry + 55));
+    m_labels.push_back(makeLabel("LINES", rx + 8, ry + 110));
 
-    drawLabel("LEVEL", rx + 8, ry + 55);
-    drawValue(std::to_string(score.level), rx + 8, ry + 73);
+    for (int i = 0; i < 3; ++i) {
+        m_values[i].text  = makeValue(rx + 8, ry + 18 + i * 55);
+        m_values[i].shown = -1;
+    }
 
-    drawLabel("LINES", rx + 8, ry + 110);
-    drawValue(std::to_string(score.lines), rx + 8, ry + 128);
+    float cx = static_cast<float>(m_originX + BOARD_W / 2);
+    float cy = static_cast<float>(m_originY + BOARD_H / 2);
 
-    if (state == GameState::Paused) {
-        // Dim overlay
-        sf::RectangleShape overlay({static_cast<float>(BOARD_W), static_cast<float>(BOARD_H)});
-        overlay.setPosition({static_cast<float>(m_originX), static_cast<float>(m_originY)});
-        overlay.setFillColor(sf::Color(0, 0, 0, 160));
-        m_window.draw(overlay);
+    m_pausedText.clear();
+    m_pausedText.push_back(makeLabel("PAUSED", cx - 30, cy - 10, 24));
 
-        drawLabel("PAUSED", static_cast<float>(m_originX + BOARD_W / 2 - 30),
-                  static_cast<float>(m_originY + BOARD_H / 2 - 10), 24);
-    }
+    m_gameOverText.clear();
+    m_gameOverText.push_back(makeLabel("GAME OVER", cx - 50, cy - 24, 24));
+    m_gameOverText.push_back(makeLabel("SPACE to restart", cx - 65, cy + 10, 16));
+}
 
-    if (state == GameState::GameOver) {
-        sf::RectangleShape overlay({static_cast<float>(BOARD_W), static_cast<float>(BOARD_H)});
-        overlay.setPosition({static_cast<float>(m_originX), static_cast<float>(m_originY)});
-        overlay.setFillColor(sf::Color(0, 0, 0, 180));
-        m_window.draw(overlay);
+void Renderer::drawText(const ScoreState& score, GameState state) {
+    if (!m_fontLoaded) return;
 
-        drawLabel("GAME OVER", static_cast<float>(m_originX + BOARD_W / 2 - 50),
-                  static_cast<float>(m_originY + BOARD_H / 2 - 24), 24);
-        drawLabel("SPACE to restart", static_cast<float>(m_originX + BOARD_W / 2 - 65),
-                  static_cast<float>(m_originY + BOARD_H / 2 + 10), 16);
-    }
+    for (const auto& label : m_labels)
+        m_window.draw(label);
+
+    drawValue(m_values[0], score.score);
+    drawValue(m_values[1], score.level);
+    drawValue(m_values[2], score.lines);
+
+    if (state == GameState::Paused)
+        for (const auto& text : m_pausedText) m_window.draw(text);
+
+    if (state == GameState::GameOver)
+        for (const auto& text : m_gameOverText) m_window.draw(text);
 }
 
 // ---------------------------------------------------------------------------
 // Main draw entry
 // ---------------------------------------------------------------------------
 
-void Renderer::drawAll(const Game& game) {
-    drawBackground();
-    drawBoard(game.board());
+// Versus: queued garbage as a red bar rising along the board's left edge
+void Renderer::addGarbageMeter(int lines) {
+    if (lines <= 0) return;
+    const float h = static_cast<float>(std::min(lines, BOARD_ROWS) * Game::CELL_PX);
+    addQuad(m_cells, m_originX - 10.f, m_originY + BOARD_H - h, 6.f, h, sf::Color(220, 40, 40));
+}
+
+void Renderer::drawAll(const RenderState& state) {
+    m_cells.clear();
+    m_window.draw(m_frame);
+    drawStack(state.board);
 
-    if (game.state() == GameState::Playing || game.state() == GameState::Paused) {
-        drawGhost(game.current(), game.ghostRow());
-        drawPiece(game.current(), {0, 0});
+    if (state.state == GameState::Playing || state.state == GameState::Paused) {
+        addGhost(state.current, state.ghostRow);
+        addPiece(state.current);
+    }
+
+    addHoldSlot(state);
+    addNextPieces(state.next);
+    addGarbageMeter(state.garbage);
+    addOverlay(state.state);
+
+    m_window.draw(m_cells);
+    drawText(state.score, state.state);
+}
+
+void Renderer::drawStatsOverlay(const std::string& text) {
+    if (!m_fontLoaded) return;
+    if (!m_statsText) {
+        m_statsText.emplace(m_font, "", 12);
+        m_statsText->setFillColor(sf::Color(120, 255, 120));
+        m_statsText->setPosition({8.f, 6.f});
+        addQuad(m_statsBackdrop, 4.f, 4.f, 250.f, 98.f, sf::Color(0, 0, 0, 190));
+    }
+    if (text != m_statsShown) {
+        m_statsText->setString(text);
+        m_statsShown = text;
     }
 
-    drawHoldSlot(game);
-    drawNextPieces(game.nextPieces());
-    drawUI(game.score(), game.state());
+    m_window.draw(m_statsBackdrop);
+    m_window.draw(*m_statsText);
 }
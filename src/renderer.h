@@ -1,6 +1,10 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <array>
+#include <optional>
+#include <vector>
 #include "game.h"
+#include "render_state.h"
 
 class Renderer {
 public:
@@ -12,7 +16,11 @@ public:
     // Load font — call once before the first drawAll()
     bool loadFont(const std::string& path);
 
-    void drawAll(const Game& game);
+    void drawAll(const RenderState& state);
+
+    // Timing overlay in the top-left corner; the text is re-laid-out only
+    // when it differs from the previous call
+    void drawStatsOverlay(const std::string& text);
 
 private:
     sf::RenderWindow& m_window;
@@ -22,24 +30,61 @@ private:
     int m_originX;
     int m_originY;
 
+    // All solid geometry goes through two triangle batches: the static frame
+    // (backgrounds, outlines, grid) built once, and the per-frame cells
+    sf::VertexArray m_frame{sf::PrimitiveType::Triangles};
+    sf::VertexArray m_cells{sf::PrimitiveType::Triangles};
+
+    // Locked cells only change when the board does, so they are rendered into
+    // an offscreen texture keyed on Board::version() and blitted each frame
+    sf::RenderTexture m_stack;
+    sf::VertexArray   m_stackCells{sf::PrimitiveType::Triangles};
+    bool              m_stackReady   = false;
+    bool              m_stackValid   = false;
+    uint32_t          m_stackVersion = 0;
+
+    // Text is laid out once in loadFont(); a value's string is only rebuilt
+    // when the number it shows changes
+    struct ValueText {
+        std::optional<sf::Text> text;
+        int                     shown = -1;
+    };
+
+    std::vector<sf::Text>    m_labels;       // HOLD, NEXT, SCORE, LEVEL, LINES
+    std::vector<sf::Text>    m_pausedText;
+    std::vector<sf::Text>    m_gameOverText;
+    std::array<ValueText, 3> m_values;       // score, level, lines
+    std::optional<sf::Text>  m_statsText;
+    std::string              m_statsShown;
+    sf::VertexArray          m_statsBackdrop{sf::PrimitiveType::Triangles}; // built with m_statsText
+
     // Panel dimensions
     static constexpr int PANEL_W = 160;
     static constexpr int BOARD_W = BOARD_COLS * Game::CELL_PX; // 320
     static constexpr int BOARD_H = BOARD_ROWS * Game::CELL_PX; // 640
 
-    void drawBackground();
-    void drawBoard(const Board& board);
-    void drawGhost(const Tetromino& current, int ghostDist);
-    void drawPiece(const Tetromino& piece, sf::Vector2i screenOffset, uint8_t alpha = 255);
-    void drawPiecePreview(TetrominoType type, sf::Vector2f center, uint8_t alpha = 255);
-    void drawHoldSlot(const Game& game);
-    void drawNextPieces(const std::array<TetrominoType, 3>& next);
-    void drawUI(const ScoreState& score, GameState state);
+    void buildFrame();
+    void addBoard(const Board& board, sf::VertexArray& batch, sf::Vector2f offset);
+    void drawStack(const Board& board);
+    void addGhost(const Tetromino& current, int ghostDist);
+    void addPiece(const Tetromino& piece, uint8_t alpha = 255);
+    void addPiecePreview(TetrominoType type, sf::Vector2f center, uint8_t alpha = 255);
+    void addHoldSlot(const RenderState& state);
+    void addNextPieces(const std::array<TetrominoType, 3>& next);
+    void addGarbageMeter(int lines);
+    void addOverlay(GameState state);
+    void buildText();
+    void drawText(const ScoreState& score, GameState state);
 
     // Convert board col/row -> screen pixel position (accounts for 2 hidden rows)
     sf::Vector2f boardToScreen(int col, int row) const;
 
-    sf::RectangleShape makeCell(float x, float y, sf::Color color, uint8_t alpha = 255) const;
-    void               drawLabel(const std::string& text, float x, float y, unsigned size = 16);
-    void               drawValue(const std::string& text, float x, float y, unsigned size = 20);
+    static sf::Color toSfColor(Color c);
+    static void      addQuad(sf::VertexArray& batch, float x, float y, float w, float h, sf::Color color);
+    static void      addOutline(sf::VertexArray& batch, float x, float y, float w, float h,
+                                float thickness, sf::Color color);
+    static void      addCell(sf::VertexArray& batch, float x, float y, sf::Color color, uint8_t alpha = 255);
+    sf::Text         makeLabel(const std::string& text, float x, float y, unsigned size = 16) const;
+    sf::Text         makeValue(float x, float y, unsigned size = 20) const;
+    void             drawValue(ValueText& value, int number);
 };
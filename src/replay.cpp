@@ -0,0 +1,149 @@
+#include "replay.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include "varint.h"
+
+static constexpr char MAGIC[4] = {'T', 'R', 'P', 'L'};
+
+// ---------------------------------------------------------------------------
+// Replay file I/O
+// ---------------------------------------------------------------------------
+
+bool Replay::save(const std::string& path) const {
+    std::vector<uint8_t> out(MAGIC, MAGIC + 4);
+    out.push_back(VERSION);
+    putVarint(out, static_cast<uint64_t>(tickRate));
+    for (int i = 0; i < 4; ++i)
+        out.push_back(static_cast<uint8_t>(seed >> (8 * i)));
+    out.insert(out.end(), stream.begin(), stream.end());
+    putVarint(out, static_cast<uint64_t>(finalScore.score));
+    putVarint(out, static_cast<uint64_t>(finalScore.lines));
+    putVarint(out, static_cast<uint64_t>(finalScore.level));
+    putVarint(out, static_cast<uint64_t>(finalPieces));
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+    return static_cast<bool>(file);
+}
+
+bool Replay::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::vector<uint8_t> in((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+
+    if (in.size() < 10 || !std::equal(MAGIC, MAGIC + 4, in.begin()) || in[4] != VERSION)
+        return false;
+
+    size_t   offset = 5;
+    uint64_t value  = 0;
+    if (!getVarint(in, offset, value) || value == 0) return false;
+    tickRate = static_cast<int>(value);
+    if (offset + 4 > in.size()) return false;
+    seed = 0;
+    for (int i = 0; i < 4; ++i)
+        seed |= static_cast<uint32_t>(in[offset++]) << (8 * i);
+
+    // Walk the records up to and including the end marker to size the stream
+    const size_t streamBegin = offset;
+    ticks = 0;
+    for (;;) {
+        uint64_t gap = 0, mask = 0;
+        if (!getVarint(in, offset, gap) || !getVarint(in, offset, mask)) return false;
+        ticks += static_cast<int64_t>(gap);
+        if (mask == END_MARKER) break;
+    }
+    stream.assign(in.begin() + streamBegin, in.begin() + offset);
+
+    uint64_t score = 0, lines = 0, level = 0, pieces = 0;
+    if (!getVarint(in, offset, score) || !getVarint(in, offset, lines) ||
+        !getVarint(in, offset, level) || !getVarint(in, offset, pieces))
+        return false;
+    finalScore        = {};
+    finalScore.score  = static_cast<int>(score);
+    finalScore.lines  = static_cast<int>(lines);
+    finalScore.level  = static_cast<int>(level);
+    finalPieces       = static_cast<int>(pieces);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Recording
+// ---------------------------------------------------------------------------
+
+ReplayRecorder::ReplayRecorder(const Game& game) {
+    m_replay.seed     = game.seed();
+    m_replay.tickRate = game.tickRate();
+}
+
+void ReplayRecorder::record(uint16_t actions) {
+    if (actions != m_lastMask) {
+        putVarint(m_replay.stream, static_cast<uint64_t>(m_replay.ticks - m_lastTick));
+        putVarint(m_replay.stream, actions);
+        m_lastMask = actions;
+        m_lastTick = m_replay.ticks;
+    }
+    ++m_replay.ticks;
+}
+
+const Replay& ReplayRecorder::finish(const Game& game) {
+    putVarint(m_replay.stream, static_cast<uint64_t>(m_replay.ticks - m_lastTick));
+    putVarint(m_replay.stream, Replay::END_MARKER);
+    m_lastTick = m_replay.ticks;
+
+    m_replay.finalScore  = game.score();
+    m_replay.finalPieces = game.pieces();
+    return m_replay;
+}
+
+// ---------------------------------------------------------------------------
+// Playback
+// ---------------------------------------------------------------------------
+
+ReplayReader::ReplayReader(const Replay& replay) : m_replay(replay) {
+    readRecord();
+}
+
+void ReplayReader::readRecord() {
+    uint64_t gap = 0, mask = 0;
+    if (!getVarint(m_replay.stream, m_offset, gap) ||
+        !getVarint(m_replay.stream, m_offset, mask)) {
+        mask = Replay::END_MARKER; // truncated stream: stop here
+        gap  = 0;
+    }
+    m_nextChange += static_cast<int64_t>(gap);
+    m_pending     = static_cast<uint32_t>(mask);
+}
+
+bool ReplayReader::next(uint16_t& actions) {
+    while (m_tick == m_nextChange) {
+        if (m_pending == Replay::END_MARKER) return false;
+        m_current = static_cast<uint16_t>(m_pending);
+        readRecord();
+    }
+    actions = m_current;
+    ++m_tick;
+    return true;
+}
+
+ReplayCheck simulateReplay(const Replay& replay) {
+    Game         game(replay.seed, replay.tickRate);
+    ReplayReader reader(replay);
+    ReplayCheck  check;
+
+    uint16_t actions = 0;
+    while (reader.next(actions)) {
+        if (!game.step(actions)) break;
+    }
+
+    check.score   = game.score();
+    check.pieces  = game.pieces();
+    check.ticks   = reader.tick();
+    check.matches = check.score.score == replay.finalScore.score &&
+                    check.score.lines == replay.finalScore.lines &&
+                    check.score.level == replay.finalScore.level &&
+                    check.pieces      == replay.finalPieces &&
+                    check.ticks       == replay.ticks;
+    return check;
+}
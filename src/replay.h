@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "game.h"
+
+// Compact binary replay: the game seed and tick rate plus the Game::step
+// action mask stream, stored only where the mask changes. Because Game is
+// deterministic for a given seed and step() sequence this is enough to
+// re-simulate the whole game; no board state is ever stored.
+//
+// File layout (all integers unsigned LEB128 varints unless noted):
+//   "TRPL"  version:u8  tickRate  seed:u32 little-endian
+//   { ticksSincePreviousChange  mask } ...
+//   ticksSincePreviousChange  END_MARKER      (covers the final run of ticks)
+//   score  lines  level  pieces               (final result, for verification)
+struct Replay {
+    // 2: bags are shuffled from (seed, bag number) instead of std::mt19937
+    static constexpr uint8_t  VERSION    = 2;
+    static constexpr uint32_t END_MARKER = 0xFFFF; // never a valid action mask
+
+    uint32_t             seed     = 0;
+    int                  tickRate = Game::DEFAULT_TICK_RATE;
+    int64_t              ticks    = 0;
+    std::vector<uint8_t> stream;   // encoded { gap, mask } records incl. end marker
+
+    // Final result as recorded; compared against the re-simulation
+    ScoreState finalScore;
+    int        finalPieces = 0;
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+};
+
+// Attach to a freshly constructed Game with Game::setRecorder(); every
+// step() mask is appended until finish() is called.
+class ReplayRecorder {
+public:
+    explicit ReplayRecorder(const Game& game);
+
+    void record(uint16_t actions);
+
+    // Seals the stream with the game's final result
+    const Replay& finish(const Game& game);
+
+    const Replay& replay() const { return m_replay; }
+
+private:
+    Replay   m_replay;
+    uint16_t m_lastMask = 0;
+    int64_t  m_lastTick = 0;
+};
+
+// Yields the recorded per-tick action masks in order
+class ReplayReader {
+public:
+    explicit ReplayReader(const Replay& replay);
+
+    // False once every recorded tick has been produced
+    bool next(uint16_t& actions);
+
+    int64_t tick() const { return m_tick; }
+
+private:
+    const Replay& m_replay;
+    size_t        m_offset     = 0;
+    int64_t       m_tick       = 0;
+    int64_t       m_nextChange = 0;     // tick at which m_pending takes effect
+    uint32_t      m_pending    = 0;     // next mask, or END_MARKER
+    uint16_t      m_current    = 0;
+
+    void readRecord();
+};
+
+struct ReplayCheck {
+    ScoreState score;
+    int        pieces  = 0;
+    int64_t    ticks   = 0;
+    bool       matches = false; // re-simulated result equals the recorded one
+};
+
+// Re-simulates a replay headlessly as fast as the CPU allows
+ReplayCheck simulateReplay(const Replay& replay);
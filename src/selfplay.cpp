@@ -0,0 +1,126 @@
+#include "selfplay.h"
+#include "replay.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <optional>
+
+// ---------------------------------------------------------------------------
+// SelfPlayStats
+// ---------------------------------------------------------------------------
+
+void SelfPlayStats::add(const GameResult& r) {
+    minScore = games == 0 ? r.score.score : std::min(minScore, r.score.score);
+    maxScore = games == 0 ? r.score.score : std::max(maxScore, r.score.score);
+    maxLevel = std::max(maxLevel, r.score.level);
+    toppedOut        += r.toppedOut ? 1 : 0;
+    replayMismatches += r.replayChecked && !r.replayMatches ? 1 : 0;
+
+    ++games;
+    pieces     += r.pieces;
+    ticks      += r.ticks;
+    totalScore += r.score.score;
+    totalLines += r.score.lines;
+}
+
+void SelfPlayStats::merge(const SelfPlayStats& other) {
+    if (other.games == 0) return;
+    minScore = games == 0 ? other.minScore : std::min(minScore, other.minScore);
+    maxScore = games == 0 ? other.maxScore : std::max(maxScore, other.maxScore);
+    maxLevel = std::max(maxLevel, other.maxLevel);
+    toppedOut        += other.toppedOut;
+    replayMismatches += other.replayMismatches;
+
+    games      += other.games;
+    pieces     += other.pieces;
+    ticks      += other.ticks;
+    totalScore += other.totalScore;
+    totalLines += other.totalLines;
+}
+
+// ---------------------------------------------------------------------------
+// SelfPlayRunner
+// ---------------------------------------------------------------------------
+
+SelfPlayRunner::SelfPlayRunner(SelfPlayConfig config)
+    : m_config(std::move(config))
+{
+    if (!m_config.policy)
+        m_config.policy = [](uint32_t seed) -> Policy { return RandomPolicy(seed); };
+}
+
+GameResult SelfPlayRunner::playOne(uint32_t seed, Policy policy,
+                                   int maxPieces, int64_t maxTicks, bool verifyReplay) {
+    Replay     replay;
+    GameResult result = play(seed, std::move(policy), maxPieces, maxTicks,
+                             verifyReplay ? &replay : nullptr);
+    if (verifyReplay) verify(result, replay);
+    return result;
+}
+
+GameResult SelfPlayRunner::play(uint32_t seed, Policy policy,
+                                int maxPieces, int64_t maxTicks, Replay* record) {
+    const auto start = std::chrono::steady_clock::now();
+
+    Game       game(seed);
+    GameResult result;
+    result.seed = seed;
+
+    std::optional<ReplayRecorder> recorder;
+    if (record) {
+        recorder.emplace(game);
+        game.setRecorder(&*recorder);
+    }
+
+    while (game.state() != GameState::GameOver) {
+        if (maxPieces > 0 && game.pieces() >= maxPieces) break;
+        if (maxTicks  > 0 && result.ticks  >= maxTicks)  break;
+        // Quit and Pause have no meaning for an unattended game
+        uint16_t actions = policy(game) & ~(actionBit(Action::Quit) | actionBit(Action::Pause));
+        game.step(actions);
+        ++result.ticks;
+    }
+
+    result.score     = game.score();
+    result.pieces    = game.pieces();
+    result.toppedOut = game.state() == GameState::GameOver;
+    if (recorder) *record = recorder->finish(game);
+    result.seconds   = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void SelfPlayRunner::verify(GameResult& result, const Replay& replay) {
+    const ReplayCheck check = simulateReplay(replay);
+    result.replayChecked = true;
+    result.replayMatches = check.matches;
+}
+
+SelfPlayStats SelfPlayRunner::run() {
+    const int games = std::max(0, m_config.games);
+    m_results.assign(games, GameResult{});
+
+    WorkStealingPool    pool(m_config.threads);
+    std::vector<Replay> replays(m_config.verifyReplays ? games : 0);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // Small chunks: game lengths vary by orders of magnitude between seeds
+    const int chunk = std::max(1, games / (pool.threadCount() * 16));
+    pool.run(games, chunk, [&](int, int i) {
+        uint32_t seed = m_config.firstSeed + static_cast<uint32_t>(i);
+        m_results[i] = play(seed, m_config.policy(seed), m_config.maxPieces, m_config.maxTicks,
+                            replays.empty() ? nullptr : &replays[i]);
+    });
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // A second, untimed pass: verification is not part of the games' cost
+    if (!replays.empty())
+        pool.run(games, chunk, [&](int, int i) { verify(m_results[i], replays[i]); });
+
+    SelfPlayStats stats;
+    for (const auto& r : m_results)
+        stats.add(r);
+    stats.seconds = seconds;
+    return stats;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "game.h"
+#include "policy.h"
+#include "replay.h"
+
+struct SelfPlayConfig {
+    int           games     = 1000;
+    uint32_t      firstSeed = 1;   // game i is played with seed firstSeed + i
+    int           threads   = 0;   // <= 0: one per hardware thread
+    int           maxPieces = 0;   // per-game cap, 0 = play until top-out
+    int64_t       maxTicks  = 0;   // per-game cap, 0 = play until top-out
+    bool          verifyReplays = false; // record each game and re-simulate it
+    PolicyFactory policy;          // defaults to RandomPolicy when empty
+};
+
+struct GameResult {
+    uint32_t   seed   = 0;
+    ScoreState score;
+    int        pieces = 0;
+    int64_t    ticks  = 0;
+    bool       toppedOut = false;
+    double     seconds   = 0.0;   // wall-clock time of this game
+    bool       replayChecked = false;
+    bool       replayMatches = false; // re-simulated replay reproduced the result
+
+    double piecesPerSecond() const { return seconds > 0.0 ? pieces / seconds : 0.0; }
+};
+
+// Aggregates over every finished game of a run
+struct SelfPlayStats {
+    int     games   = 0;
+    int64_t pieces  = 0;
+    int64_t ticks   = 0;
+    double  seconds = 0.0; // wall-clock time of the whole run, replay checks excluded
+
+    double gamesPerSecond()  const { return seconds > 0.0 ? games  / seconds : 0.0; }
+    double piecesPerSecond() const { return seconds > 0.0 ? pieces / seconds : 0.0; }
+
+    int64_t totalScore = 0;
+    int64_t totalLines = 0;
+    int     minScore   = 0;
+    int     maxScore   = 0;
+    int     maxLevel   = 0;
+    int     toppedOut  = 0;
+    int     replayMismatches = 0;
+
+    double meanScore() const { return games > 0 ? double(totalScore) / games : 0.0; }
+    double meanLines() const { return games > 0 ? double(totalLines) / games : 0.0; }
+
+    void add(const GameResult& r);
+    void merge(const SelfPlayStats& other);
+};
+
+// Plays config.games independent seeded games to completion on a
+// WorkStealingPool. Every game is driven through Game::step only, so any
+// single result can be reproduced from its seed and policy.
+class SelfPlayRunner {
+public:
+    explicit SelfPlayRunner(SelfPlayConfig config);
+
+    SelfPlayStats run();
+
+    // Per-game results of the last run(), indexed by game number
+    const std::vector<GameResult>& results() const { return m_results; }
+
+    // Plays one game on the calling thread. With verifyReplay the game is
+    // recorded and the replay re-simulated against the live result.
+    static GameResult playOne(uint32_t seed, Policy policy,
+                              int maxPieces = 0, int64_t maxTicks = 0,
+                              bool verifyReplay = false);
+
+private:
+    // Plays and times one game, recording it into *record when non-null
+    static GameResult play(uint32_t seed, Policy policy, int maxPieces, int64_t maxTicks,
+                           Replay* record);
+    static void       verify(GameResult& result, const Replay& replay);
+
+    SelfPlayConfig          m_config;
+    std::vector<GameResult> m_results;
+};
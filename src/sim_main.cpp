@@ -0,0 +1,195 @@
+// Headless batch simulator: plays a range of seeded games with a built-in
+// policy on a WorkStealingPool and reports per-game and aggregate results.
+// Options are listed in USAGE below, which -h/--help prints.
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "cli_args.h"
+#include "selfplay.h"
+
+static const char USAGE[] =
+    "Usage: tetris_sim [--seeds FIRST-LAST | --seed FIRST --games N] [--threads N]\n"
+    "                  [--max-pieces N] [--max-ticks N] [--policy random|beam]\n"
+    "                  [--beam-width N] [--beam-depth N] [--format json|csv]\n"
+    "                  [--output FILE] [--verify-replays]\n"
+    "  --seeds           inclusive seed range, one game per seed (default 1-100)\n"
+    "  --seed/--games    the same range given as a start and a count\n"
+    "  --threads         worker threads, 0 = one per hardware thread (default 0)\n"
+    "  --max-pieces      stop each game after N pieces, 0 = until top-out\n"
+    "  --max-ticks       stop each game after N ticks, 0 = until top-out\n"
+    "  --policy          random (RandomPolicy) or beam (BeamSearchPolicy)\n"
+    "  --beam-width/-depth  BeamConfig for --policy beam\n"
+    "  --format          json (default) or csv; csv ends with an \"all\" row\n"
+    "  --output          write to FILE instead of stdout\n"
+    "  --verify-replays  record every game and check its replay re-simulates\n"
+    "                    to the same result; any mismatch exits with status 2\n";
+
+// The runner indexes games with an int and seeds with a uint32_t
+static bool parseRange(const std::string& text, uint32_t& first, int& games) {
+    const size_t dash = text.find('-');
+    if (dash == std::string::npos) return false;
+    unsigned long long lo, hi;
+    if (!parseUnsigned(text.substr(0, dash).c_str(), UINT32_MAX, lo) ||
+        !parseUnsigned(text.c_str() + dash + 1, UINT32_MAX, hi) || hi < lo ||
+        hi - lo >= static_cast<unsigned long long>(INT_MAX))
+        return false;
+    first = static_cast<uint32_t>(lo);
+    games = static_cast<int>(hi - lo + 1);
+    return true;
+}
+
+static void writeCsv(std::FILE* out, const std::vector<GameResult>& results,
+                     const SelfPlayStats& stats) {
+    std::fprintf(out, "seed,score,lines,level,pieces,ticks,topped_out,seconds,pieces_per_second,"
+                      "replay_ok\n");
+    for (const GameResult& r : results)
+        std::fprintf(out, "%u,%d,%d,%d,%d,%lld,%d,%.6f,%.1f,%s\n", r.seed, r.score.score,
+                     r.score.lines, r.score.level, r.pieces, static_cast<long long>(r.ticks),
+                     r.toppedOut ? 1 : 0, r.seconds, r.piecesPerSecond(),
+                     !r.replayChecked ? "" : r.replayMatches ? "1" : "0");
+
+    // Aggregate row: totals for the counters, best level, wall time of the run
+    std::fprintf(out, "all,%lld,%lld,%d,%lld,%lld,%d,%.6f,%.1f,%s\n",
+                 static_cast<long long>(stats.totalScore), static_cast<long long>(stats.totalLines),
+                 stats.maxLevel, static_cast<long long>(stats.pieces),
+                 static_cast<long long>(stats.ticks), stats.toppedOut, stats.seconds,
+                 stats.piecesPerSecond(),
+                 results.empty() || !results[0].replayChecked ? ""
+                 : stats.replayMismatches == 0                ? "1" : "0");
+}
+
+static void writeJson(std::FILE* out, const SelfPlayConfig& config, const char* policy,
+                      int threads, const std::vector<GameResult>& results,
+                      const SelfPlayStats& stats) {
+    std::fprintf(out, "{\n  \"config\": {\"first_seed\": %u, \"games\": %d, \"threads\": %d, "
+                      "\"policy\": \"%s\", \"max_pieces\": %d, \"max_ticks\": %lld, "
+                      "\"verify_replays\": %s},\n",
+                 config.firstSeed, config.games, threads, policy, config.maxPieces,
+                 static_cast<long long>(config.maxTicks), config.verifyReplays ? "true" : "false");
+
+    std::fprintf(out, "  \"aggregate\": {\"games\": %d, \"pieces\": %lld, \"ticks\": %lld, "
+                      "\"seconds\": %.6f, \"games_per_second\": %.2f, \"pieces_per_second\": %.1f, "
+                      "\"mean_score\": %.2f, \"min_score\": %d, \"max_score\": %d, "
+                      "\"mean_lines\": %.2f, \"max_level\": %d, \"topped_out\": %d, "
+                      "\"replay_mismatches\": %d},\n",
+                 stats.games, static_cast<long long>(stats.pieces),
+                 static_cast<long long>(stats.ticks), stats.seconds, stats.gamesPerSecond(),
+                 stats.piecesPerSecond(), stats.meanScore(), stats.minScore, stats.maxScore,
+                 stats.meanLines(), stats.maxLevel, stats.toppedOut, stats.replayMismatches);
+
+    std::fprintf(out, "  \"games\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const GameResult& r = results[i];
+        std::fprintf(out, "%s\n    {\"seed\": %u, \"score\": %d, \"lines\": %d, \"level\": %d, "
+                          "\"pieces\": %d, \"ticks\": %lld, \"topped_out\": %s, "
+                          "\"seconds\": %.6f, \"pieces_per_second\": %.1f",
+                     i ? "," : "", r.seed, r.score.score, r.score.lines, r.score.level, r.pieces,
+                     static_cast<long long>(r.ticks), r.toppedOut ? "true" : "false", r.seconds,
+                     r.piecesPerSecond());
+        if (r.replayChecked)
+            std::fprintf(out, ", \"replay_ok\": %s", r.replayMatches ? "true" : "false");
+        std::fprintf(out, "}");
+    }
+    std::fprintf(out, "%s]\n}\n", results.empty() ? "" : "\n  ");
+}
+
+int main(int argc, char** argv) {
+    SelfPlayConfig config;
+    config.games = 100;
+    BeamConfig  beam;
+    std::string policy = "random", format = "json", outputPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg  = argv[i];
+        const char*       next = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "-h" || arg == "--help") {
+            std::fputs(USAGE, stdout);
+            return 0;
+        }
+        if (arg == "--verify-replays") {
+            config.verifyReplays = true;
+            continue;
+        }
+        if (!next) {
+            std::fprintf(stderr, "tetris_sim: %s needs a value\n", arg.c_str());
+            return 1;
+        }
+        ++i;
+        if (arg == "--seeds") {
+            if (!parseRange(next, config.firstSeed, config.games)) {
+                std::fprintf(stderr, "tetris_sim: bad seed range '%s'\n", next);
+                return 1;
+            }
+        }
+        else if (arg == "--seed" || arg == "--games" || arg == "--threads" ||
+                 arg == "--max-pieces" || arg == "--max-ticks" || arg == "--beam-width" ||
+                 arg == "--beam-depth") {
+            unsigned long long value = 0;
+            bool               ok;
+            if (arg == "--seed")            ok = parseUnsigned(next, UINT32_MAX, value);
+            else if (arg == "--max-ticks")  ok = parseUnsigned(next, INT64_MAX, value);
+            else if (arg == "--beam-width" || arg == "--beam-depth")
+                                            ok = parseUnsigned(next, INT_MAX, value) && value > 0;
+            else                            ok = parseUnsigned(next, INT_MAX, value);
+            if (!ok) {
+                std::fprintf(stderr, "tetris_sim: bad %s '%s'\n", arg.c_str(), next);
+                return 1;
+            }
+            if (arg == "--seed")            config.firstSeed = static_cast<uint32_t>(value);
+            else if (arg == "--games")      config.games     = static_cast<int>(value);
+            else if (arg == "--threads")    config.threads   = static_cast<int>(value);
+            else if (arg == "--max-pieces") config.maxPieces = static_cast<int>(value);
+            else if (arg == "--max-ticks")  config.maxTicks  = static_cast<int64_t>(value);
+            else if (arg == "--beam-width") beam.width       = static_cast<int>(value);
+            else                            beam.depth       = static_cast<int>(value);
+        }
+        else if (arg == "--policy")     policy           = next;
+        else if (arg == "--format")     format           = next;
+        else if (arg == "--output")     outputPath       = next;
+        else {
+            std::fprintf(stderr, "tetris_sim: unknown option %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    // --seed/--games can describe a range that runs past the last seed
+    if (config.games > 0 && config.firstSeed > UINT32_MAX - static_cast<uint32_t>(config.games - 1)) {
+        std::fprintf(stderr, "tetris_sim: seed range runs past %u\n", UINT32_MAX);
+        return 1;
+    }
+
+    if (policy == "beam")
+        config.policy = [beam](uint32_t) -> Policy { return BeamSearchPolicy(beam); };
+    else if (policy != "random") {
+        std::fprintf(stderr, "tetris_sim: unknown policy '%s' (random|beam)\n", policy.c_str());
+        return 1;
+    }
+    if (format != "json" && format != "csv") {
+        std::fprintf(stderr, "tetris_sim: unknown format '%s' (json|csv)\n", format.c_str());
+        return 1;
+    }
+
+    std::FILE* out = stdout;
+    if (!outputPath.empty() && !(out = std::fopen(outputPath.c_str(), "w"))) {
+        std::fprintf(stderr, "tetris_sim: cannot write '%s'\n", outputPath.c_str());
+        return 1;
+    }
+
+    const int threads = config.threads > 0
+                      ? config.threads
+                      : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    SelfPlayRunner runner(config);
+    const SelfPlayStats stats = runner.run();
+
+    if (format == "csv")
+        writeCsv(out, runner.results(), stats);
+    else
+        writeJson(out, config, policy.c_str(), threads, runner.results(), stats);
+    if (out != stdout) std::fclose(out);
+
+    return stats.replayMismatches > 0 ? 2 : 0;
+}
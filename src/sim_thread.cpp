@@ -0,0 +1,81 @@
+#include "sim_thread.h"
+#include <chrono>
+
+SimulationThread::SimulationThread(Game& game, ReplayReader* playback)
+    : m_game(game), m_playback(playback)
+{
+    // Make a valid frame available before the first tick runs
+    publish();
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start() {
+    if (m_running.exchange(true)) return;
+    m_thread = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+    m_running.store(false);
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+uint64_t SimulationThread::pushKey(sf::Keyboard::Key key, bool pressed) {
+    // A full queue means the sim thread is stalled; dropping is preferable
+    // to blocking the window thread
+    if (!m_keys.push({key, pressed, InputHandler::nowUs(), m_keysPushed + 1})) return 0;
+    return ++m_keysPushed;
+}
+
+void SimulationThread::publish() {
+    SimFrame& frame = m_states.back();
+    frame.state.capture(m_game);
+    frame.ticks       = m_ticks;
+    frame.keysApplied = m_keysApplied;
+    m_states.publish();
+}
+
+void SimulationThread::run() {
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::nanoseconds(1'000'000'000LL / m_game.tickRate());
+
+    auto nextTick = Clock::now();
+    while (m_running.load(std::memory_order_relaxed)) {
+        const auto tickStart = Clock::now();
+
+        KeyEvent key;
+        while (m_keys.pop(key)) {
+            m_input.handleKey(key.key, key.pressed, key.timeUs);
+            m_keysApplied = key.seq;
+        }
+        m_input.update(InputHandler::nowUs());
+
+        bool keepGoing = true;
+        if (m_playback) {
+            uint16_t actions = 0;
+            if (m_playback->next(actions)) m_game.step(actions);
+            keepGoing = !m_input.isJustPressed(Action::Quit);
+        } else {
+            keepGoing = m_game.step(m_input.actionMask(BOARD_COLS));
+        }
+        m_ticks.add(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - tickStart)
+                        .count());
+        publish();
+
+        if (!keepGoing) {
+            m_quit.store(true, std::memory_order_release);
+            break;
+        }
+
+        // Fixed schedule; after a long stall (debugger, suspend) resync
+        // instead of fast-forwarding through the missed ticks
+        nextTick += period;
+        const auto now = Clock::now();
+        if (now - nextTick > std::chrono::milliseconds(250))
+            nextTick = now;
+        std::this_thread::sleep_until(nextTick);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <SFML/Window.hpp>
+#include <atomic>
+#include <thread>
+#include "frame_stats.h"
+#include "game.h"
+#include "input.h"
+#include "render_state.h"
+#include "replay.h"
+#include "spsc_queue.h"
+#include "triple_buffer.h"
+
+// What the simulation thread publishes after every tick
+struct SimFrame {
+    RenderState state;
+    TickSamples ticks;           // duration of each tick body
+    uint64_t    keysApplied = 0; // sequence number of the last key event in state
+};
+
+// Runs a Game at its own fixed tick rate on a dedicated thread, independent
+// of the render frame rate. The window thread forwards key events through a
+// lock-free queue and reads the latest RenderState through a triple buffer;
+// nothing else is shared, and neither side ever blocks on the other.
+class SimulationThread {
+public:
+    // playback: optional replay to step instead of live input (Esc still quits)
+    SimulationThread(Game& game, ReplayReader* playback = nullptr);
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&)            = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    void start();
+    void stop(); // joins; the Game may be used again afterwards
+
+    // Window thread: forward a key press/release, stamped on arrival so DAS
+    // timing doesn't depend on when the next tick drains the queue. Returns
+    // the event's sequence number (compare with SimFrame::keysApplied), or 0
+    // if the queue was full and the event was dropped.
+    uint64_t pushKey(sf::Keyboard::Key key, bool pressed);
+
+    // Call before start(); DAS/ARR and bindings are owned by the sim thread after
+    InputHandler& input() { return m_input; }
+
+    // Window thread: newest published state
+    const SimFrame& latest() { return m_states.read(); }
+
+    // Set once the game asks to quit (Quit action)
+    bool quitRequested() const { return m_quit.load(std::memory_order_acquire); }
+
+private:
+    struct KeyEvent {
+        sf::Keyboard::Key key     = sf::Keyboard::Key::Unknown;
+        bool              pressed = false;
+        int64_t           timeUs  = 0;
+        uint64_t          seq     = 0;
+    };
+
+    void run();
+    void publish();
+
+    Game&         m_game;
+    ReplayReader* m_playback;
+    InputHandler  m_input;
+
+    SpscQueue<KeyEvent, 256> m_keys;
+    TripleBuffer<SimFrame>   m_states;
+    uint64_t                 m_keysPushed  = 0; // window thread
+    uint64_t                 m_keysApplied = 0; // sim thread
+    TickSamples              m_ticks;           // sim thread
+
+    std::thread       m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_quit{false};
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free single-producer / single-consumer ring buffer.
+// Capacity must be a power of two; push() fails rather than blocking when full.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    bool push(const T& value) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity) return false;
+        m_items[tail & (Capacity - 1)] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& out) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+        out = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> m_items{};
+    alignas(64) std::atomic<size_t> m_head{0}; // consumer
+    alignas(64) std::atomic<size_t> m_tail{0}; // producer
+};
@@ -1,6 +1,29 @@
 #pragma once
 #include <array>
-#include <SFML/Graphics.hpp>
+#include <cstdint>
+
+// Plain value types so the simulation core builds without SFML.
+// The renderer converts these to sf::Color / sf::Vector2 at draw time.
+struct Vec2i {
+    int x = 0;
+    int y = 0;
+};
+
+constexpr Vec2i operator+(Vec2i a, Vec2i b) { return {a.x + b.x, a.y + b.y}; }
+constexpr bool  operator==(Vec2i a, Vec2i b) { return a.x == b.x && a.y == b.y; }
+constexpr bool  operator!=(Vec2i a, Vec2i b) { return !(a == b); }
+
+struct Color {
+    uint8_t r = 0;
+    uint8_t g = 0;
+    uint8_t b = 0;
+    uint8_t a = 255;
+};
+
+constexpr bool operator==(Color x, Color y) {
+    return x.r == y.r && x.g == y.g && x.b == y.b && x.a == y.a;
+}
+constexpr bool operator!=(Color x, Color y) { return !(x == y); }
 
 enum class TetrominoType : int {
     I = 0, J, L, O, S, T, Z,
@@ -11,7 +34,7 @@ enum class TetrominoType : int {
 // rotations[state][cell][0=x, 1=y]
 struct TetrominoData {
     int       rotations[4][4][2];
-    sf::Color color;
+    Color     color;
 };
 
 // kick offsets[from_state][attempt][0=x, 1=y] — 5 attempts per transition
@@ -19,12 +42,17 @@ struct KickData {
     int offsets[4][5][2];
 };
 
-extern const TetrominoData TETROMINO_DATA[7];
+// Occupancy of one rotation state as row bitmasks relative to the pivot.
+// rows[i] covers pivot row minY+i; bit b covers pivot column minX+b.
+struct PieceMask {
+    uint16_t rows[4];
+    int      minX, maxX;
+    int      minY, height;
+    int      bottoms[4]; // lowest cell's y offset in column minX + i
+};
 
-extern const KickData SRS_KICKS_JLSTZ_CW;
-extern const KickData SRS_KICKS_JLSTZ_CCW;
-extern const KickData SRS_KICKS_I_CW;
-extern const KickData SRS_KICKS_I_CCW;
+// TETROMINO_DATA, the SRS kick tables, pieceMask() and kickDataFor() live in
+// piece_tables.h
 
 class Tetromino {
 public:
@@ -32,17 +60,17 @@ public:
 
     TetrominoType type()          const { return m_type; }
     int           rotationState() const { return m_rotation; }
-    sf::Vector2i  position()      const { return m_pos; }
-    sf::Color     color()         const;
+    Vec2i         position()      const { return m_pos; }
+    Color         color()         const;
 
-    std::array<sf::Vector2i, 4> worldCells() const;
-    std::array<sf::Vector2i, 4> worldCellsAt(sf::Vector2i pos, int rotation) const;
+    std::array<Vec2i, 4> worldCells() const;
+    std::array<Vec2i, 4> worldCellsAt(Vec2i pos, int rotation) const;
 
-    void setPosition(sf::Vector2i pos) { m_pos = pos; }
+    void setPosition(Vec2i pos)        { m_pos = pos; }
     void setRotation(int state)        { m_rotation = state & 3; }
 
 private:
     TetrominoType m_type;
-    sf::Vector2i  m_pos;
+    Vec2i         m_pos;
     int           m_rotation;
 };
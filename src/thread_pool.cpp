@@ -0,0 +1,94 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(int threads) {
+    if (threads <= 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 0; i < threads; ++i)
+        m_queues.push_back(std::make_unique<Queue>());
+    for (int i = 0; i < threads; ++i)
+        m_threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_threads)
+        t.join();
+}
+
+void WorkStealingPool::run(int taskCount, int chunkSize,
+                           const std::function<void(int, int)>& fn) {
+    if (taskCount <= 0) return;
+    chunkSize = std::max(1, chunkSize);
+
+    // Deal chunks before waking anyone: no new work appears mid-batch, so a
+    // worker that finds every deque empty can safely report itself idle
+    const int workers = threadCount();
+    int       next    = 0;
+    for (int begin = 0; begin < taskCount; begin += chunkSize) {
+        Queue& q = *m_queues[next];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.ranges.emplace_back(begin, std::min(taskCount, begin + chunkSize));
+        next = (next + 1) % workers;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_job  = &fn;
+    m_busy = workers;
+    ++m_generation;
+    m_wake.notify_all();
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_job = nullptr;
+}
+
+bool WorkStealingPool::popOrSteal(int worker, Range& out) {
+    {
+        Queue& own = *m_queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.ranges.empty()) {
+            out = own.ranges.back();
+            own.ranges.pop_back();
+            return true;
+        }
+    }
+
+    const int workers = threadCount();
+    for (int i = 1; i < workers; ++i) {
+        Queue& victim = *m_queues[(worker + i) % workers];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.ranges.empty()) {
+            out = victim.ranges.front();
+            victim.ranges.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(int worker) {
+    uint64_t seen = 0;
+    for (;;) {
+        const std::function<void(int, int)>* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+            job  = m_job;
+        }
+
+        Range range;
+        while (popOrSteal(worker, range))
+            for (int task = range.first; task < range.second; ++task)
+                (*job)(worker, task);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busy == 0)
+            m_done.notify_one();
+    }
+}
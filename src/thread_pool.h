@@ -0,0 +1,53 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Fixed set of worker threads for run-to-completion batches. Each batch is
+// split into chunks dealt round-robin onto per-worker deques; a worker pops
+// from the back of its own deque and, once empty, steals from the front of
+// the others, so uneven task lengths still keep every core busy.
+class WorkStealingPool {
+public:
+    // threads <= 0 uses std::thread::hardware_concurrency()
+    explicit WorkStealingPool(int threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&)            = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int threadCount() const { return static_cast<int>(m_threads.size()); }
+
+    // Calls fn(worker, task) for every task in [0, taskCount), chunkSize tasks
+    // at a time, and blocks until all have finished. worker is in
+    // [0, threadCount()) and identifies the calling thread for per-worker state.
+    void run(int taskCount, int chunkSize, const std::function<void(int, int)>& fn);
+
+private:
+    using Range = std::pair<int, int>; // [begin, end)
+
+    struct Queue {
+        std::mutex        mutex;
+        std::deque<Range> ranges;
+    };
+
+    void workerLoop(int worker);
+    bool popOrSteal(int worker, Range& out);
+
+    std::vector<std::thread>            m_threads;
+    std::vector<std::unique_ptr<Queue>> m_queues;
+
+    std::mutex                               m_mutex;
+    std::condition_variable                  m_wake;
+    std::condition_variable                  m_done;
+    const std::function<void(int, int)>*     m_job        = nullptr;
+    uint64_t                                 m_generation = 0;
+    int                                      m_busy       = 0;
+    bool                                     m_stop       = false;
+};
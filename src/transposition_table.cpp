@@ -0,0 +1,38 @@
+#include "transposition_table.h"
+
+static size_t roundUpPow2(size_t n) {
+    size_t p = 2;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+TranspositionTable::TranspositionTable(size_t entries)
+    : m_slots(new Slot[roundUpPow2(entries)]), m_mask(roundUpPow2(entries) - 1)
+{
+    clear();
+}
+
+// Zobrist keys are uniformly mixed, so the low bits index the table directly
+bool TranspositionTable::probe(uint64_t key, uint64_t& value) const {
+    const Slot&    slot = m_slots[key & m_mask];
+    const uint64_t v    = slot.value.load(std::memory_order_relaxed);
+    const uint64_t c    = slot.check.load(std::memory_order_relaxed);
+    if ((c ^ v) != key) return false;
+    value = v;
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, uint64_t value) {
+    Slot& slot = m_slots[key & m_mask];
+    slot.value.store(value, std::memory_order_relaxed);
+    slot.check.store(key ^ value, std::memory_order_relaxed);
+}
+
+// With value 0, slot i matches only key i ^ 1, which indexes slot i ^ 1
+// (the table has at least two slots)
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= m_mask; ++i) {
+        m_slots[i].check.store(i ^ 1, std::memory_order_relaxed);
+        m_slots[i].value.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Fixed-size hash table shared by concurrent searches, keyed by
+// Board::hash() / Game::hash(). Lock-free: each slot holds the value and
+// key ^ value as two relaxed atomics, so a slot torn by racing writers fails
+// the key check on probe and reads as a miss instead of returning a value
+// stored for another position. Stores always replace; the table never grows.
+// An empty slot's check word names a key that indexes a different slot, so
+// no key (0 included) can hit a slot that was never stored.
+class TranspositionTable {
+public:
+    // entries is rounded up to a power of two (at least 2)
+    explicit TranspositionTable(size_t entries);
+
+    TranspositionTable(const TranspositionTable&)            = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    size_t size() const { return m_mask + 1; }
+
+    // True and sets value if key was stored and not overwritten since
+    bool probe(uint64_t key, uint64_t& value) const;
+
+    void store(uint64_t key, uint64_t value);
+
+    // Not safe to call while other threads probe or store
+    void clear();
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check{0}; // key ^ value; slot index ^ 1 when empty
+        std::atomic<uint64_t> value{0};
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t                  m_mask;
+};
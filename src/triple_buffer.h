@@ -0,0 +1,39 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer / single-consumer triple buffer. The producer
+// fills back() and publish()es it; the consumer's read() returns the newest
+// published value. Neither side ever waits, and each side only touches slots
+// the other cannot see, so T needs no synchronisation of its own.
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer side
+    T& back() { return m_slots[m_back]; }
+
+    void publish() {
+        uint8_t prev = m_middle.exchange(static_cast<uint8_t>(m_back | FRESH),
+                                         std::memory_order_acq_rel);
+        m_back = prev & INDEX;
+    }
+
+    // Consumer side: swaps in the latest published slot if there is one
+    const T& read() {
+        if (m_middle.load(std::memory_order_relaxed) & FRESH) {
+            uint8_t prev = m_middle.exchange(m_front, std::memory_order_acq_rel);
+            m_front = prev & INDEX;
+        }
+        return m_slots[m_front];
+    }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4; // middle slot holds an unread value
+
+    std::array<T, 3>     m_slots{};
+    uint8_t              m_back  = 0;   // producer-owned
+    uint8_t              m_front = 1;   // consumer-owned
+    std::atomic<uint8_t> m_middle{2};
+};
@@ -0,0 +1,293 @@
+#include "versus_protocol.h"
+#include "varint.h"
+
+namespace versus {
+
+// ---------------------------------------------------------------------------
+// Byte helpers
+// ---------------------------------------------------------------------------
+
+namespace {
+
+void putU16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+// Bounds-checked cursor over a payload; any short read sets ok = false
+struct Reader {
+    const std::vector<uint8_t>& in;
+    size_t                      offset = 0;
+    bool                        ok     = true;
+
+    uint8_t u8() {
+        if (offset + 1 > in.size()) { ok = false; return 0; }
+        return in[offset++];
+    }
+    uint16_t u16() {
+        uint16_t lo = u8();
+        return static_cast<uint16_t>(lo | (u8() << 8));
+    }
+    uint32_t u32() {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(u8()) << (8 * i);
+        return v;
+    }
+    uint64_t varint() {
+        uint64_t v = 0;
+        if (!getVarint(in, offset, v)) ok = false;
+        return v;
+    }
+};
+
+// Board colors travel as 3-bit codes: the tetromino type whose color it is,
+// or 7 for garbage (and anything else)
+constexpr uint8_t GARBAGE_CODE = 7;
+
+uint8_t colorCode(Color c) {
+    for (int t = 0; t < 7; ++t)
+        if (TETROMINO_DATA[t].color == c) return static_cast<uint8_t>(t);
+    return GARBAGE_CODE;
+}
+
+Color codeColor(uint8_t code) {
+    return code < GARBAGE_CODE ? TETROMINO_DATA[code].color : GARBAGE_COLOR;
+}
+
+uint32_t packRowColors(const Board& board, int row) {
+    uint32_t packed = 0;
+    for (int c = 0; c < BOARD_COLS; ++c)
+        if ((board.rowMask(row) >> c) & 1u)
+            packed |= static_cast<uint32_t>(colorCode(board.cellColor(c, row))) << (3 * c);
+    return packed;
+}
+
+bool sameRow(const Board& a, const Board& b, int row) {
+    if (a.rowMask(row) != b.rowMask(row)) return false;
+    for (int c = 0; c < BOARD_COLS; ++c)
+        if (a.cellColor(c, row) != b.cellColor(c, row)) return false;
+    return true;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Framing
+// ---------------------------------------------------------------------------
+
+void writeMessage(std::vector<uint8_t>& out, MsgType type, const std::vector<uint8_t>& payload) {
+    putU16(out, static_cast<uint16_t>(payload.size() + 1));
+    out.push_back(static_cast<uint8_t>(type));
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+bool readMessage(std::vector<uint8_t>& in, MsgType& type, std::vector<uint8_t>& payload) {
+    if (in.size() < 2) return false;
+    const size_t length = in[0] | (static_cast<size_t>(in[1]) << 8);
+    if (length == 0 || in.size() < 2 + length) return false;
+
+    type = static_cast<MsgType>(in[2]);
+    payload.assign(in.begin() + 3, in.begin() + 2 + length);
+    in.erase(in.begin(), in.begin() + 2 + length);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Small messages
+// ---------------------------------------------------------------------------
+
+std::vector<uint8_t> encodeWelcome(const Welcome& welcome) {
+    std::vector<uint8_t> out{PROTOCOL_VERSION, welcome.player, welcome.players};
+    putU16(out, welcome.tickRate);
+    return out;
+}
+
+bool decodeWelcome(const std::vector<uint8_t>& payload, Welcome& welcome) {
+    Reader in{payload};
+    const uint8_t version = in.u8();
+    welcome.player   = in.u8();
+    welcome.players  = in.u8();
+    welcome.tickRate = in.u16();
+    return in.ok && version == PROTOCOL_VERSION;
+}
+
+std::vector<uint8_t> encodeInput(uint16_t actions) {
+    std::vector<uint8_t> out;
+    putU16(out, actions);
+    return out;
+}
+
+bool decodeInput(const std::vector<uint8_t>& payload, uint16_t& actions) {
+    Reader in{payload};
+    actions = in.u16();
+    return in.ok;
+}
+
+// ---------------------------------------------------------------------------
+// StateEncoder
+// ---------------------------------------------------------------------------
+
+StateEncoder::StateEncoder(int players)
+    : m_sent(players), m_valid(players, false)
+{}
+
+void StateEncoder::writeBlock(std::vector<uint8_t>& out, int player, uint8_t fields,
+                              const RenderState& now, const RenderState* prev) {
+    out.push_back(static_cast<uint8_t>(player));
+    out.push_back(fields);
+
+    if (fields & FIELD_PIECE) {
+        const Tetromino& p = now.current;
+        out.push_back(static_cast<uint8_t>(static_cast<int>(p.type()) | (p.rotationState() << 3)));
+        out.push_back(static_cast<uint8_t>(static_cast<int8_t>(p.position().x)));
+        out.push_back(static_cast<uint8_t>(static_cast<int8_t>(p.position().y)));
+        out.push_back(static_cast<uint8_t>(now.ghostRow));
+    }
+    if (fields & FIELD_ROWS) {
+        const size_t countAt = out.size();
+        out.push_back(0);
+        for (int r = 0; r < BOARD_ROWS_TOTAL; ++r) {
+            if (prev && sameRow(prev->board, now.board, r)) continue;
+            out.push_back(static_cast<uint8_t>(r));
+            putU16(out, now.board.rowMask(r));
+            putU32(out, packRowColors(now.board, r));
+            ++out[countAt];
+        }
+    }
+    if (fields & FIELD_GARBAGE)
+        putVarint(out, static_cast<uint64_t>(now.garbage));
+    if (fields & FIELD_SCORE) {
+        putVarint(out, static_cast<uint64_t>(now.score.score));
+        putVarint(out, static_cast<uint64_t>(now.score.level));
+        putVarint(out, static_cast<uint64_t>(now.score.lines));
+        putVarint(out, static_cast<uint64_t>(now.score.combo));
+    }
+    if (fields & FIELD_QUEUE) {
+        out.push_back(now.hasHeld ? static_cast<uint8_t>(now.held) : 0xFF);
+        out.push_back(now.holdUsed ? 1 : 0);
+        for (TetrominoType t : now.next) out.push_back(static_cast<uint8_t>(t));
+    }
+    if (fields & FIELD_STATE)
+        out.push_back(static_cast<uint8_t>(now.state));
+}
+
+std::vector<uint8_t> StateEncoder::snapshot(uint32_t tick, const std::vector<RenderState>& now) const {
+    std::vector<uint8_t> out;
+    putVarint(out, tick);
+    out.push_back(static_cast<uint8_t>(now.size()));
+    for (size_t i = 0; i < now.size(); ++i)
+        writeBlock(out, static_cast<int>(i), FIELD_ALL, now[i], nullptr);
+    return out;
+}
+
+std::vector<uint8_t> StateEncoder::delta(uint32_t tick, const std::vector<RenderState>& now) {
+    std::vector<uint8_t> out;
+    putVarint(out, tick);
+    const size_t countAt = out.size();
+    out.push_back(0);
+
+    for (size_t i = 0; i < now.size() && i < m_sent.size(); ++i) {
+        const RenderState& n = now[i];
+        const RenderState& s = m_sent[i];
+
+        uint8_t fields = FIELD_ALL;
+        if (m_valid[i]) {
+            fields = 0;
+            const Tetromino& a = n.current;
+            const Tetromino& b = s.current;
+            if (a.type() != b.type() || a.rotationState() != b.rotationState() ||
+                a.position() != b.position() || n.ghostRow != s.ghostRow)
+                fields |= FIELD_PIECE;
+            if (n.board.version() != s.board.version())
+                fields |= FIELD_ROWS;
+            if (n.garbage != s.garbage)
+                fields |= FIELD_GARBAGE;
+            if (n.score.score != s.score.score || n.score.level != s.score.level ||
+                n.score.lines != s.score.lines || n.score.combo != s.score.combo)
+                fields |= FIELD_SCORE;
+            if (n.hasHeld != s.hasHeld || n.held != s.held || n.holdUsed != s.holdUsed ||
+                n.next != s.next)
+                fields |= FIELD_QUEUE;
+            if (n.state != s.state)
+                fields |= FIELD_STATE;
+        }
+        if (!fields) continue;
+
+        writeBlock(out, static_cast<int>(i), fields, n, m_valid[i] ? &s : nullptr);
+        ++out[countAt];
+        m_sent[i]  = n;
+        m_valid[i] = true;
+    }
+    if (out[countAt] == 0) out.clear();
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Client side
+// ---------------------------------------------------------------------------
+
+bool applyState(const std::vector<uint8_t>& payload, std::vector<RenderState>& players,
+                uint32_t& tick) {
+    Reader in{payload};
+    tick = static_cast<uint32_t>(in.varint());
+    const int count = in.u8();
+
+    for (int b = 0; b < count && in.ok; ++b) {
+        const int     player = in.u8();
+        const uint8_t fields = in.u8();
+        if (player >= static_cast<int>(players.size())) return false;
+        RenderState& st = players[player];
+
+        if (fields & FIELD_PIECE) {
+            const uint8_t typeRot = in.u8();
+            const int8_t  x       = static_cast<int8_t>(in.u8());
+            const int8_t  y       = static_cast<int8_t>(in.u8());
+            st.ghostRow = in.u8();
+            if ((typeRot & 7) >= 7) return false;
+            st.current = Tetromino(static_cast<TetrominoType>(typeRot & 7));
+            st.current.setRotation(typeRot >> 3);
+            st.current.setPosition({x, y});
+        }
+        if (fields & FIELD_ROWS) {
+            const int rows = in.u8();
+            if (rows > BOARD_ROWS_TOTAL) return false;
+            for (int i = 0; i < rows && in.ok; ++i) {
+                const int      row    = in.u8();
+                const uint16_t mask   = in.u16();
+                const uint32_t packed = in.u32();
+                if (row >= BOARD_ROWS_TOTAL) return false;
+                std::array<Color, BOARD_COLS> colors;
+                for (int c = 0; c < BOARD_COLS; ++c)
+                    colors[c] = codeColor(static_cast<uint8_t>((packed >> (3 * c)) & 7u));
+                st.board.setRow(row, mask, colors);
+            }
+        }
+        if (fields & FIELD_GARBAGE)
+            st.garbage = static_cast<int>(in.varint());
+        if (fields & FIELD_SCORE) {
+            st.score.score = static_cast<int>(in.varint());
+            st.score.level = static_cast<int>(in.varint());
+            st.score.lines = static_cast<int>(in.varint());
+            st.score.combo = static_cast<int>(in.varint());
+        }
+        if (fields & FIELD_QUEUE) {
+            const uint8_t held = in.u8();
+            st.hasHeld  = held < 7;
+            if (st.hasHeld) st.held = static_cast<TetrominoType>(held);
+            st.holdUsed = in.u8() != 0;
+            for (auto& t : st.next) t = static_cast<TetrominoType>(in.u8() % 7);
+        }
+        if (fields & FIELD_STATE) {
+            const uint8_t state = in.u8();
+            if (state > static_cast<uint8_t>(GameState::GameOver)) return false;
+            st.state = static_cast<GameState>(state);
+        }
+    }
+    return in.ok && in.offset == payload.size(); // nothing may trail the last block
+}
+
+} // namespace versus
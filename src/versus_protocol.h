@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "render_state.h"
+
+// Wire format for versus mode. Every message is framed as
+//   length:u16 LE (type byte + payload)  type:u8  payload
+// Client -> server: Hello, Input. Server -> client: Welcome, then one
+// Snapshot on join and a Delta per tick carrying only what changed.
+//
+// A state message is  tick:varint  count:u8  { player block } * count, where
+// a block is  player:u8  fields:u8  followed by the fields flagged:
+//   PIECE    type|rotation<<3:u8  x:i8  y:i8  ghostRow:u8
+//   ROWS     count:u8  { row:u8  mask:u16 LE  colors:u32 LE } * count
+//            (3-bit color code per column: tetromino type, 7 = garbage)
+//   GARBAGE  queued lines:varint
+//   SCORE    score  level  lines  combo   (varints)
+//   QUEUE    held:u8 (0xFF none)  holdUsed:u8  next:u8 x3
+//   STATE    GameState:u8
+namespace versus {
+
+constexpr uint8_t  PROTOCOL_VERSION = 1;
+constexpr uint16_t DEFAULT_PORT     = 47323;
+constexpr uint8_t  SPECTATOR        = 0xFF; // Welcome player id for watchers
+constexpr size_t   MAX_MESSAGE      = 0xFFFF;
+
+enum class MsgType : uint8_t {
+    Hello    = 1, // version:u8
+    Input    = 2, // actions:u16 LE, Game::step mask for the sender's next tick
+    Welcome  = 3, // version:u8  player:u8  players:u8  tickRate:u16 LE
+    Snapshot = 4, // state message, every field of every player
+    Delta    = 5, // state message, changed fields only
+};
+
+enum Field : uint8_t {
+    FIELD_PIECE   = 1 << 0,
+    FIELD_ROWS    = 1 << 1,
+    FIELD_GARBAGE = 1 << 2,
+    FIELD_SCORE   = 1 << 3,
+    FIELD_QUEUE   = 1 << 4,
+    FIELD_STATE   = 1 << 5,
+    FIELD_ALL     = 0x3F,
+};
+
+// Appends a framed message to out
+void writeMessage(std::vector<uint8_t>& out, MsgType type, const std::vector<uint8_t>& payload);
+
+// Pops one complete message from the front of in; false if none is buffered
+// yet. Lengths are u16 on the wire, so no frame exceeds MAX_MESSAGE.
+bool readMessage(std::vector<uint8_t>& in, MsgType& type, std::vector<uint8_t>& payload);
+
+struct Welcome {
+    uint8_t  player   = SPECTATOR;
+    uint8_t  players  = 0;
+    uint16_t tickRate = 60;
+};
+
+std::vector<uint8_t> encodeWelcome(const Welcome& welcome);
+bool                 decodeWelcome(const std::vector<uint8_t>& payload, Welcome& welcome);
+
+std::vector<uint8_t> encodeInput(uint16_t actions);
+bool                 decodeInput(const std::vector<uint8_t>& payload, uint16_t& actions);
+
+// Server side: remembers what each client has been sent and encodes the
+// difference. Rows are only compared when Board::version() moved.
+class StateEncoder {
+public:
+    explicit StateEncoder(int players);
+
+    // Full state of every player, for a client that just joined. Does not
+    // change what later deltas are relative to.
+    std::vector<uint8_t> snapshot(uint32_t tick, const std::vector<RenderState>& now) const;
+
+    // Changes since the previous delta; empty if nothing changed
+    std::vector<uint8_t> delta(uint32_t tick, const std::vector<RenderState>& now);
+
+private:
+    std::vector<RenderState> m_sent;
+    std::vector<bool>        m_valid;
+
+    static void writeBlock(std::vector<uint8_t>& out, int player, uint8_t fields,
+                           const RenderState& now, const RenderState* prev);
+};
+
+// Client side: applies Snapshot and Delta payloads to a mirror of every
+// player's RenderState, sized to Welcome::players. Returns false on a
+// malformed message, including one naming a player past that count.
+bool applyState(const std::vector<uint8_t>& payload, std::vector<RenderState>& players,
+                uint32_t& tick);
+
+} // namespace versus
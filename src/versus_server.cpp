@@ -0,0 +1,231 @@
+// Headless versus server: steps every player's Game on one fixed tick, routes
+// garbage between them and streams state deltas to players and spectators.
+//
+// Usage: tetris_versus_server [--players N] [--listen ADDR] [--seed S] [--tick-rate HZ]
+//   --players    games in the match, 1-254 (default 2); later clients spectate
+//   --listen     "host:port" or a Unix socket path (default ":47323")
+//   --seed       piece seed shared by every player (default: random)
+//   --tick-rate  simulation ticks per second, 1-65535 (default 60)
+// The match starts once every player slot is taken and the server exits when
+// at most one player is left standing and every client has disconnected.
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cli_args.h"
+#include "game.h"
+#include "net_socket.h"
+#include "render_state.h"
+#include "versus_protocol.h"
+
+namespace {
+
+struct Client {
+    net::Connection conn;
+    int             player  = versus::SPECTATOR;
+    bool            greeted = false; // Hello received, Welcome sent
+    bool            synced  = false; // Snapshot sent; deltas from here on
+};
+
+// Input received since the previous tick. Taps are OR-ed so none is lost
+// when two Input messages arrive within one tick; SoftDrop is a held state,
+// so the most recent message decides it.
+struct PendingInput {
+    uint16_t actions = 0;
+    bool     softDrop = false;
+
+    void add(uint16_t mask) {
+        const int repeats = std::max(moveRepeats(actions), moveRepeats(mask));
+        actions  = withMoveRepeats(actions | mask, repeats);
+        softDrop = hasAction(mask, Action::SoftDrop);
+    }
+
+    // The sender is gone: nothing stays held, but its last taps still
+    // reach the next tick
+    void release() { softDrop = false; }
+
+    uint16_t take() {
+        // A client can't pause or end the shared match
+        uint16_t mask = actions & ~(actionBit(Action::Pause) | actionBit(Action::Quit) |
+                                    actionBit(Action::SoftDrop));
+        if (softDrop) mask |= actionBit(Action::SoftDrop);
+        actions = 0;
+        return mask;
+    }
+};
+
+int alivePlayers(const std::vector<Game>& games) {
+    return static_cast<int>(std::count_if(games.begin(), games.end(), [](const Game& g) {
+        return g.state() != GameState::GameOver;
+    }));
+}
+
+// Next living opponent after `from`, round-robin so garbage is spread evenly
+int garbageTarget(const std::vector<Game>& games, int from, int& cursor) {
+    const int n = static_cast<int>(games.size());
+    for (int step = 1; step <= n; ++step) {
+        const int p = (cursor + step) % n;
+        if (p != from && games[p].state() != GameState::GameOver) {
+            cursor = p;
+            return p;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int         players  = 2;
+    int         tickRate = 60;
+    uint32_t    seed     = std::random_device{}();
+    std::string address  = ":" + std::to_string(versus::DEFAULT_PORT);
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string        arg   = argv[i];
+        const char*        value = argv[i + 1];
+        unsigned long long seedValue;
+        bool               ok    = true;
+        if (arg == "--players")        ok = parseInt(value, 1, 254, players);
+        else if (arg == "--listen")    address = value;
+        else if (arg == "--seed")      ok = parseUnsigned(value, UINT32_MAX, seedValue);
+        else if (arg == "--tick-rate") ok = parseInt(value, 1, 0xFFFF, tickRate);
+        if (!ok) {
+            std::fprintf(stderr, "tetris_versus_server: bad %s '%s'\n", arg.c_str(), value);
+            return 1;
+        }
+        if (arg == "--seed") seed = static_cast<uint32_t>(seedValue);
+    }
+
+    const int listener = net::listenOn(address);
+    if (listener < 0) {
+        std::fprintf(stderr, "tetris_versus_server: cannot listen on '%s'\n", address.c_str());
+        return 1;
+    }
+    std::printf("listening on %s for %d players (seed %u)\n", address.c_str(), players, seed);
+
+    // Every player gets the same piece sequence
+    std::vector<Game> games;
+    games.reserve(players);
+    for (int p = 0; p < players; ++p) games.emplace_back(seed, tickRate);
+
+    std::vector<PendingInput> inputs(players);
+    std::vector<RenderState>  states(players);
+    std::vector<bool>         taken(players, false);
+    std::vector<Client>       clients;
+    versus::StateEncoder      encoder(players);
+
+    using Clock = std::chrono::steady_clock;
+    const auto tickDuration = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / tickRate));
+    auto     nextTick      = Clock::now();
+    uint32_t tick          = 0;
+    int      garbageCursor = 0;
+    bool     started       = false;
+    bool     everJoined    = false;
+
+    std::vector<uint8_t> payload;
+    for (;;) {
+        // Accept and greet
+        for (int fd; (fd = net::acceptOn(listener)) >= 0;)
+            clients.push_back(Client{net::Connection(fd)});
+
+        for (Client& c : clients) {
+            // A peer may send its last input and close in the same read: on
+            // EOF receive() closes the connection, but what it had buffered
+            // is still handed out by next() before the disconnect is handled
+            const bool open = c.conn.receive();
+            versus::MsgType type;
+            while (c.conn.next(type, payload)) {
+                if (type == versus::MsgType::Hello && !c.greeted && open) {
+                    if (payload.empty() || payload[0] != versus::PROTOCOL_VERSION) {
+                        c.conn.close();
+                        break;
+                    }
+                    const auto free = std::find(taken.begin(), taken.end(), false);
+                    if (free != taken.end()) {
+                        *free    = true;
+                        c.player = static_cast<int>(free - taken.begin());
+                    }
+                    c.greeted = true;
+                    c.conn.send(versus::MsgType::Welcome,
+                                versus::encodeWelcome({static_cast<uint8_t>(c.player),
+                                                       static_cast<uint8_t>(players),
+                                                       static_cast<uint16_t>(tickRate)}));
+                    everJoined = true;
+                } else if (type == versus::MsgType::Input && c.player != versus::SPECTATOR) {
+                    uint16_t actions;
+                    if (versus::decodeInput(payload, actions)) inputs[c.player].add(actions);
+                }
+            }
+        }
+
+        // A player who leaves tops out; their slot is not reused. Inputs they
+        // sent still apply on the next tick, but a held SoftDrop is let go.
+        for (Client& c : clients) {
+            if (c.conn.isOpen() || c.player == versus::SPECTATOR) continue;
+            if (started) games[c.player].receiveGarbage(BOARD_ROWS_TOTAL);
+            inputs[c.player].release();
+            c.player = versus::SPECTATOR;
+        }
+        clients.erase(std::remove_if(clients.begin(), clients.end(),
+                                     [](const Client& c) { return !c.conn.isOpen(); }),
+                      clients.end());
+
+        started = started || std::all_of(taken.begin(), taken.end(), [](bool t) { return t; });
+
+        const auto now = Clock::now();
+        if (now < nextTick) {
+            std::this_thread::sleep_until(std::min(nextTick, now + std::chrono::milliseconds(1)));
+            continue;
+        }
+        nextTick += tickDuration;
+        if (now - nextTick > 8 * tickDuration) nextTick = now; // don't snowball after a stall
+
+        if (started) {
+            ++tick;
+            for (int p = 0; p < players; ++p)
+                if (games[p].state() == GameState::Playing) games[p].step(inputs[p].take());
+
+            for (int p = 0; p < players; ++p) {
+                const int lines = games[p].takeOutgoingGarbage();
+                if (lines == 0) continue;
+                const int target = garbageTarget(games, p, garbageCursor);
+                if (target >= 0) games[target].receiveGarbage(lines);
+            }
+        }
+
+        for (int p = 0; p < players; ++p) states[p].capture(games[p]);
+        const std::vector<uint8_t> delta = encoder.delta(tick, states);
+
+        // Newcomers get a snapshot taken after this tick's delta, so the
+        // next delta applies on top of it. So does a client too slow to take
+        // its deltas: once its queue is full the deltas still waiting are
+        // dropped and one snapshot replaces them.
+        for (Client& c : clients) {
+            if (!c.greeted) continue;
+            if (c.synced && !delta.empty() && !c.conn.send(versus::MsgType::Delta, delta)) {
+                c.conn.dropQueued();
+                c.synced = false;
+            }
+            if (!c.synced) {
+                c.conn.send(versus::MsgType::Snapshot, encoder.snapshot(tick, states));
+                c.synced = true;
+            }
+            c.conn.flush();
+        }
+
+        if (started && alivePlayers(games) <= 1 && everJoined && clients.empty()) break;
+    }
+
+    for (int p = 0; p < players; ++p)
+        std::printf("player %d: score %d, lines %d%s\n", p, games[p].score().score,
+                    games[p].score().lines,
+                    games[p].state() != GameState::GameOver ? " (winner)" : "");
+    net::closeSocket(listener);
+    return 0;
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+// SplitMix64 step: a cheap generator with well-mixed 64-bit outputs, used to
+// fill the Zobrist key tables deterministically at startup
+inline uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
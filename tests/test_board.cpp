@@ -0,0 +1,135 @@
+// Board's table-driven fast paths against cell-by-cell references:
+// fits<T>() and isValidPosition() (COLUMN_MASKS), firstFreeKick<T>()
+// (KICK_MASKS), ghostDropDistance() (column profile) and lockPiece()
+// (line clears, incremental hash and column tops).
+#include <array>
+#include <vector>
+#include "test_util.h"
+
+using namespace test;
+
+namespace {
+
+constexpr int BOARDS = 200;
+
+void checkCollision(const Board& board, Failures& failures) {
+    for (TetrominoType type : ALL_TYPES) {
+        withPieceType(type, [&](auto tag) {
+            constexpr TetrominoType T = decltype(tag)::value;
+            const Tetromino         piece(T);
+            for (int rot = 0; rot < 4; ++rot)
+                for (int y = Y_MIN; y < Y_MAX; ++y)
+                    for (int x = X_MIN; x < X_MAX; ++x) {
+                        const bool expected = referenceFits(board, T, {x, y}, rot);
+                        if (board.fits<T>({x, y}, rot) != expected)
+                            failures.report("fits<%d> at (%d,%d) rot %d: expected %d\n",
+                                            static_cast<int>(T), x, y, rot, expected);
+                        if (board.isValidPosition(piece, {x, y}, rot) != expected)
+                            failures.report("isValidPosition type %d at (%d,%d) rot %d: expected %d\n",
+                                            static_cast<int>(T), x, y, rot, expected);
+                    }
+        });
+    }
+}
+
+void checkKicks(const Board& board, Failures& failures) {
+    for (TetrominoType type : ALL_TYPES) {
+        withPieceType(type, [&](auto tag) {
+            constexpr TetrominoType T = decltype(tag)::value;
+            if constexpr (T != TetrominoType::O) {
+                for (int from = 0; from < 4; ++from)
+                    for (int direction : {1, -1})
+                        for (int y = Y_MIN; y < Y_MAX; ++y)
+                            for (int x = X_MIN; x < X_MAX; ++x) {
+                                const int expected = referenceKick(board, T, {x, y}, from, direction);
+                                const int kick     = board.firstFreeKick<T>({x, y}, from, direction);
+                                if (kick != expected)
+                                    failures.report("firstFreeKick<%d> at (%d,%d) rot %d dir %d: "
+                                                    "got %d, expected %d\n",
+                                                    static_cast<int>(T), x, y, from, direction,
+                                                    kick, expected);
+                            }
+            }
+        });
+    }
+}
+
+void checkDrop(const Board& board, Failures& failures) {
+    for (TetrominoType type : ALL_TYPES) {
+        Tetromino piece(type);
+        for (int rot = 0; rot < 4; ++rot)
+            for (int y = 0; y < BOARD_ROWS_TOTAL; ++y)
+                for (int x = X_MIN; x < X_MAX; ++x) {
+                    if (!referenceFits(board, type, {x, y}, rot)) continue;
+                    piece.setRotation(rot);
+                    piece.setPosition({x, y});
+                    int expected = 0;
+                    while (referenceFits(board, type, {x, y + expected + 1}, rot)) ++expected;
+                    const int dist = board.ghostDropDistance(piece);
+                    if (dist != expected)
+                        failures.report("ghostDropDistance type %d at (%d,%d) rot %d: got %d, expected %d\n",
+                                        static_cast<int>(type), x, y, rot, dist, expected);
+                }
+    }
+}
+
+// Locks a dropped piece and compares against marking the cells and removing
+// full rows one by one
+void checkLock(Board board, std::mt19937& rng, Failures& failures) {
+    const TetrominoType type = ALL_TYPES[rng() % 7];
+    const int           rot  = static_cast<int>(rng() % 4);
+    Tetromino           piece(type);
+    piece.setRotation(rot);
+    piece.setPosition({static_cast<int>(rng() % BOARD_COLS), 1});
+    if (!board.isValidPosition(piece, piece.position(), rot)) return;
+    piece.setPosition(piece.position() + Vec2i{0, board.ghostDropDistance(piece)});
+
+    std::array<uint16_t, BOARD_ROWS_TOTAL> rows;
+    for (int r = 0; r < BOARD_ROWS_TOTAL; ++r) rows[r] = board.rowMask(r);
+    for (const Vec2i& c : piece.worldCells())
+        rows[c.y] |= static_cast<uint16_t>(1u << c.x);
+
+    std::vector<uint16_t> kept;
+    uint32_t              clearedRows = 0;
+    for (int r = 0; r < BOARD_ROWS_TOTAL; ++r) {
+        if (rows[r] == FULL_ROW_MASK) clearedRows |= 1u << r;
+        else                          kept.push_back(rows[r]);
+    }
+    const int cleared = BOARD_ROWS_TOTAL - static_cast<int>(kept.size());
+    rows.fill(0);
+    std::copy(kept.begin(), kept.end(), rows.begin() + cleared);
+
+    if (board.lockPiece(piece) != cleared || board.lastClearedRows() != clearedRows)
+        failures.report("lockPiece type %d: wrong rows cleared (%d expected)\n",
+                        static_cast<int>(type), cleared);
+
+    Board rebuilt;
+    for (int r = 0; r < BOARD_ROWS_TOTAL; ++r) {
+        rebuilt.setRow(r, rows[r]);
+        if (board.rowMask(r) != rows[r])
+            failures.report("lockPiece type %d: row %d is %03x, expected %03x\n",
+                            static_cast<int>(type), r, board.rowMask(r), rows[r]);
+    }
+    if (board.hash() != rebuilt.hash())
+        failures.report("lockPiece type %d: incremental hash differs from a rebuilt board\n",
+                        static_cast<int>(type));
+    for (int c = 0; c < BOARD_COLS; ++c)
+        if (board.columnTop(c) != rebuilt.columnTop(c))
+            failures.report("lockPiece type %d: column %d top %d, expected %d\n",
+                            static_cast<int>(type), c, board.columnTop(c), rebuilt.columnTop(c));
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20261016);
+    Failures     failures;
+    for (int i = 0; i < BOARDS; ++i) {
+        const Board board = i == 0 ? Board() : randomBoard(rng);
+        checkCollision(board, failures);
+        checkKicks(board, failures);
+        checkDrop(board, failures);
+        for (int l = 0; l < 20; ++l) checkLock(board, rng, failures);
+    }
+    return failures.finish("test_board");
+}
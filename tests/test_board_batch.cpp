@@ -0,0 +1,98 @@
+// BoardBatch lane by lane against Board and the cell-by-cell reference.
+// Built once per kernel set; argv[1] names the set this binary must have
+// compiled in ("scalar", "sse2" or "avx2").
+#include <cstring>
+#include <string>
+#include <vector>
+#include "board_batch.h"
+#include "test_util.h"
+
+using namespace test;
+
+namespace {
+
+constexpr int LANES  = 40; // not a multiple of LANE_BLOCK: the last block is partial
+constexpr int ROUNDS = 50;
+constexpr int SKIP   = 77; // ctest SKIP_RETURN_CODE
+
+void checkValid(const BoardBatch& batch, const std::vector<Board>& boards, Failures& failures) {
+    std::vector<uint8_t> out(batch.lanes());
+    for (TetrominoType type : ALL_TYPES)
+        for (int rot = 0; rot < 4; ++rot)
+            for (int y = Y_MIN; y < Y_MAX; ++y)
+                for (int x = X_MIN; x < X_MAX; ++x) {
+                    batch.validPositions(type, {x, y}, rot, out.data());
+                    for (int l = 0; l < batch.lanes(); ++l) {
+                        const bool expected =
+                            referenceFits(l < LANES ? boards[l] : Board(), type, {x, y}, rot);
+                        if (out[l] != (expected ? 1 : 0))
+                            failures.report("validPositions type %d at (%d,%d) rot %d lane %d: "
+                                            "got %d, expected %d\n",
+                                            static_cast<int>(type), x, y, rot, l, out[l], expected);
+                    }
+                }
+}
+
+// The same placement locked into every lane, clipped at the edges like
+// Board::lockPiece
+void checkLock(BoardBatch& batch, std::vector<Board>& boards, std::mt19937& rng, Failures& failures) {
+    const TetrominoType type = ALL_TYPES[rng() % 7];
+    const int           rot  = static_cast<int>(rng() % 4);
+    const Vec2i         pos{static_cast<int>(rng() % (BOARD_COLS + 2)) - 1,
+                            static_cast<int>(rng() % BOARD_ROWS_TOTAL)};
+    Tetromino piece(type);
+    piece.setRotation(rot);
+    piece.setPosition(pos);
+
+    std::vector<uint8_t> cleared(batch.lanes());
+    batch.lockPiece(type, pos, rot, cleared.data());
+    for (int l = 0; l < LANES; ++l) {
+        const int expected = boards[l].lockPiece(piece);
+        if (cleared[l] != expected)
+            failures.report("lockPiece type %d at (%d,%d) rot %d lane %d: cleared %d, expected %d\n",
+                            static_cast<int>(type), pos.x, pos.y, rot, l, cleared[l], expected);
+        for (int r = 0; r < BOARD_ROWS_TOTAL; ++r)
+            if (batch.rowMask(l, r) != boards[l].rowMask(r))
+                failures.report("lockPiece type %d at (%d,%d) rot %d lane %d: row %d is %03x, "
+                                "expected %03x\n",
+                                static_cast<int>(type), pos.x, pos.y, rot, l, r,
+                                batch.rowMask(l, r), boards[l].rowMask(r));
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* kernel = BoardBatch::kernelName();
+    if (argc > 1 && std::strcmp(argv[1], kernel) != 0) {
+        std::fprintf(stderr, "test_board_batch: built with the %s kernels, expected %s\n", kernel, argv[1]);
+        return 1;
+    }
+#if defined(__AVX2__) && (defined(__GNUC__) || defined(__clang__))
+    if (!__builtin_cpu_supports("avx2")) {
+        std::printf("test_board_batch (%s): skipped, CPU lacks AVX2\n", kernel);
+        return SKIP;
+    }
+#endif
+
+    std::mt19937 rng(20261016);
+    Failures     failures;
+    for (int round = 0; round < ROUNDS; ++round) {
+        BoardBatch         batch(LANES);
+        std::vector<Board> boards;
+        for (int l = 0; l < LANES; ++l) {
+            boards.push_back(randomBoard(rng));
+            batch.setLane(l, boards[l]);
+        }
+        for (int l = 0; l < LANES; ++l)
+            for (int r = 0; r < BOARD_ROWS_TOTAL; ++r)
+                if (batch.lane(l).rowMask(r) != boards[l].rowMask(r))
+                    failures.report("setLane/lane round trip: lane %d row %d differs\n", l, r);
+
+        if (round % 10 == 0) checkValid(batch, boards, failures);
+        for (int lock = 0; lock < 20; ++lock) checkLock(batch, boards, rng, failures);
+    }
+
+    const std::string name = std::string("test_board_batch (") + kernel + ")";
+    return failures.finish(name.c_str());
+}
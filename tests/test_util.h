@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdio>
+#include <random>
+#include "board.h"
+#include "piece_tables.h"
+#include "tetromino.h"
+
+// Shared pieces of the headless tests: random stacks, and cell-by-cell
+// reference versions of the bitmask fast paths to check them against.
+namespace test {
+
+inline constexpr TetrominoType ALL_TYPES[] = {
+    TetrominoType::I, TetrominoType::J, TetrominoType::L, TetrominoType::O,
+    TetrominoType::S, TetrominoType::T, TetrominoType::Z,
+};
+
+// Pivot ranges that run a few cells past every edge of the board
+constexpr int X_MIN = -4, X_MAX = BOARD_COLS + 4;
+constexpr int Y_MIN = -4, Y_MAX = BOARD_ROWS_TOTAL + 4;
+
+// A ragged stack of random height with holes, overhangs and, now and then,
+// rows that are one cell short of full so locks clear lines
+inline Board randomBoard(std::mt19937& rng) {
+    Board     board;
+    const int height = static_cast<int>(rng() % (BOARD_ROWS_TOTAL + 1));
+    for (int r = BOARD_ROWS_TOTAL - height; r < BOARD_ROWS_TOTAL; ++r) {
+        uint16_t mask = static_cast<uint16_t>(rng() & rng() & FULL_ROW_MASK);
+        if (rng() % 4 == 0) mask = FULL_ROW_MASK & ~static_cast<uint16_t>(1u << (rng() % BOARD_COLS));
+        board.setRow(r, mask);
+    }
+    return board;
+}
+
+// Every cell of the piece is on the board and empty
+inline bool referenceFits(const Board& board, TetrominoType type, Vec2i pos, int rotation) {
+    for (const Vec2i& c : Tetromino(type).worldCellsAt(pos, rotation))
+        if (board.isOccupied(c.x, c.y)) return false; // out of bounds counts as occupied
+    return true;
+}
+
+// The first SRS kick that fits, trying one candidate at a time
+inline int referenceKick(const Board& board, TetrominoType type, Vec2i pos, int from, int direction) {
+    const KickData* kicks = kickDataFor(type, direction);
+    for (int k = 0; kicks && k < 5; ++k) {
+        const Vec2i kicked = pos + Vec2i{kicks->offsets[from][k][0], kicks->offsets[from][k][1]};
+        if (referenceFits(board, type, kicked, (from + direction) & 3)) return k;
+    }
+    return -1;
+}
+
+// Counts failed checks, printing the first few
+class Failures {
+public:
+    template <typename... Args>
+    void report(const char* format, Args... args) {
+        if (m_count++ < 10) std::fprintf(stderr, format, args...);
+    }
+
+    int count() const { return m_count; }
+
+    // Process exit status for the test
+    int finish(const char* name) const {
+        if (m_count) std::fprintf(stderr, "%s: %d failed checks\n", name, m_count);
+        else         std::printf("%s: ok\n", name);
+        return m_count ? 1 : 0;
+    }
+
+private:
+    int m_count = 0;
+};
+
+} // namespace test
@@ -0,0 +1,131 @@
+// Versus state messages end to end: a snapshot plus a delta per tick from
+// stepped Games must rebuild every player's RenderState through applyState,
+// and truncated or oversized payloads must be rejected.
+#include <vector>
+#include "policy.h"
+#include "render_state.h"
+#include "test_util.h"
+#include "versus_protocol.h"
+
+using namespace test;
+
+namespace {
+
+constexpr int PLAYERS   = 2;
+constexpr int MAX_TICKS = 20000;
+
+void checkMirror(const std::vector<RenderState>& live, const std::vector<RenderState>& mirror,
+                 uint32_t tick, Failures& failures) {
+    for (int p = 0; p < PLAYERS; ++p) {
+        const RenderState& a = live[p];
+        const RenderState& b = mirror[p];
+        for (int r = 0; r < BOARD_ROWS_TOTAL; ++r) {
+            bool same = a.board.rowMask(r) == b.board.rowMask(r);
+            for (int c = 0; c < BOARD_COLS && same; ++c)
+                same = a.board.cellColor(c, r) == b.board.cellColor(c, r);
+            if (!same)
+                failures.report("tick %u player %d: row %d differs\n", tick, p, r);
+        }
+        if (a.current.type() != b.current.type() ||
+            a.current.rotationState() != b.current.rotationState() ||
+            a.current.position() != b.current.position() || a.ghostRow != b.ghostRow)
+            failures.report("tick %u player %d: piece differs\n", tick, p);
+        if (a.hasHeld != b.hasHeld || (a.hasHeld && a.held != b.held) ||
+            a.holdUsed != b.holdUsed || a.next != b.next)
+            failures.report("tick %u player %d: hold or queue differs\n", tick, p);
+        if (a.score.score != b.score.score || a.score.level != b.score.level ||
+            a.score.lines != b.score.lines || a.score.combo != b.score.combo)
+            failures.report("tick %u player %d: score differs\n", tick, p);
+        if (a.state != b.state || a.garbage != b.garbage)
+            failures.report("tick %u player %d: state or garbage differs\n", tick, p);
+    }
+}
+
+// Every strict prefix of a valid payload is a malformed message
+void checkTruncated(const std::vector<uint8_t>& payload, const std::vector<RenderState>& mirror,
+                    Failures& failures) {
+    for (size_t length = 0; length < payload.size(); ++length) {
+        std::vector<RenderState> scratch = mirror;
+        uint32_t                 tick;
+        const std::vector<uint8_t> prefix(payload.begin(), payload.begin() + length);
+        if (versus::applyState(prefix, scratch, tick))
+            failures.report("payload cut to %zu of %zu bytes was accepted\n", length, payload.size());
+    }
+}
+
+void expectRejected(const char* what, const std::vector<uint8_t>& payload, int players,
+                    Failures& failures) {
+    std::vector<RenderState> scratch(players);
+    uint32_t                 tick;
+    if (versus::applyState(payload, scratch, tick))
+        failures.report("%s was accepted\n", what);
+}
+
+void checkOversized(const std::vector<uint8_t>& snapshot, Failures& failures) {
+    std::vector<uint8_t> trailing = snapshot;
+    trailing.push_back(0);
+    expectRejected("snapshot with a trailing byte", trailing, PLAYERS, failures);
+    expectRejected("snapshot for more players than negotiated", snapshot, PLAYERS - 1, failures);
+
+    // tick 0, one block for player PLAYERS with no fields
+    expectRejected("player id past the count", {0, 1, PLAYERS, 0}, PLAYERS, failures);
+
+    // tick 0, one ROWS block for player 0 naming a row below the board
+    expectRejected("row past the board",
+                   {0, 1, 0, versus::FIELD_ROWS, 1, BOARD_ROWS_TOTAL, 0, 0, 0, 0, 0, 0},
+                   PLAYERS, failures);
+    expectRejected("more rows than the board has",
+                   {0, 1, 0, versus::FIELD_ROWS, BOARD_ROWS_TOTAL + 1}, PLAYERS, failures);
+}
+
+} // namespace
+
+int main() {
+    std::vector<Game>   games;
+    std::vector<Policy> policies;
+    for (int p = 0; p < PLAYERS; ++p) {
+        games.emplace_back(7);
+        policies.push_back(RandomPolicy(static_cast<uint32_t>(p + 1)));
+    }
+
+    std::vector<RenderState> live(PLAYERS), mirror(PLAYERS);
+    versus::StateEncoder     encoder(PLAYERS);
+    Failures                 failures;
+
+    // As the server does for a newcomer: the first delta, then a snapshot
+    // that the following deltas apply on top of
+    for (int p = 0; p < PLAYERS; ++p) live[p].capture(games[p]);
+    encoder.delta(0, live);
+    const std::vector<uint8_t> snapshot = encoder.snapshot(0, live);
+    uint32_t                   tick     = 0;
+    if (!versus::applyState(snapshot, mirror, tick))
+        failures.report("snapshot was rejected\n");
+    checkMirror(live, mirror, 0, failures);
+    checkTruncated(snapshot, mirror, failures);
+    checkOversized(snapshot, failures);
+
+    int deltas = 0;
+    for (uint32_t t = 1; t <= MAX_TICKS; ++t) {
+        bool playing = false;
+        for (int p = 0; p < PLAYERS; ++p) {
+            if (games[p].state() != GameState::Playing) continue;
+            playing = true;
+            games[p].step(policies[p](games[p]));
+            if (t % 150 == 0) games[p].receiveGarbage(1 + p);
+        }
+        if (!playing) break;
+
+        for (int p = 0; p < PLAYERS; ++p) live[p].capture(games[p]);
+        const std::vector<uint8_t> delta = encoder.delta(t, live);
+        if (delta.empty()) continue;
+
+        if (deltas++ % 50 == 0) checkTruncated(delta, mirror, failures);
+        if (!versus::applyState(delta, mirror, tick) || tick != t)
+            failures.report("delta for tick %u was rejected\n", t);
+        checkMirror(live, mirror, t, failures);
+    }
+    if (deltas < 100)
+        failures.report("only %d deltas were encoded\n", deltas);
+
+    return failures.finish("test_versus_protocol");
+}